@@ -32,7 +32,14 @@ POSSIBILITY OF SUCH DAMAGE.
  */
 
 #include "Adafruit_GFX.h"
+#include "GFXstreamFont.h"
+#include "GFXimage.h"
 #include "glcdfont.c"
+#include <math.h>
+
+#if !defined(__MBED__)
+#include <chrono>
+#endif
 
 #ifndef min
 #define min(a, b) (((a) < (b)) ? (a) : (b))
@@ -60,12 +67,6 @@ Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h)
     _width = WIDTH;
     _height = HEIGHT;
     rotation = 0;
-    cursor_y = cursor_x = 0;
-    textsize = 1;
-    textcolor = textbgcolor = 0xFFFF;
-    wrap = true;
-    _cp437 = false;
-    gfxFont = NULL;
 }
 
 /**************************************************************************/
@@ -272,6 +273,63 @@ void Adafruit_GFX::fillScreen(uint16_t color)
     fillRect(0, 0, _width, _height, color);
 }
 
+/**************************************************************************/
+/*!
+   @brief    Fill many rectangles in one transaction. Update in subclasses if desired!
+    @param    rects   Rectangles, drawn in order (zero or negative sizes are skipped)
+    @param    colors  16-bit 5-6-5 color of each rectangle
+    @param    n       Number of rectangles
+*/
+/**************************************************************************/
+void Adafruit_GFX::fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n)
+{
+    startWrite();
+    for (uint16_t i = 0; i < n; i++)
+    {
+        if ((rects[i].w > 0) && (rects[i].h > 0))
+            writeFillRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h, colors[i]);
+    }
+    endWrite();
+}
+
+/**************************************************************************/
+/*!
+   @brief    Draw many horizontal spans in one transaction. Update in subclasses if desired!
+    @param    spans  Spans, drawn in order (zero or negative widths are skipped)
+    @param    n      Number of spans
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawSpans(const GFXspan *spans, uint16_t n)
+{
+    startWrite();
+    for (uint16_t i = 0; i < n; i++)
+    {
+        if (spans[i].w > 0)
+            writeFastHLine(spans[i].x, spans[i].y, spans[i].w, spans[i].color);
+    }
+    endWrite();
+}
+
+/**************************************************************************/
+/*!
+   @brief    Move the pixels of a rectangle by (dx, dy) within it, e.g. to
+   scroll part of the screen; pixels moved outside it are dropped, and the
+   area uncovered is left for the caller to redraw. Generic version can't
+   read pixels back, so does nothing.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    w   Width in pixels
+    @param    h   Height in pixels
+    @param    dx  Distance to move right (negative: left)
+    @param    dy  Distance to move down (negative: up)
+    @returns  true if moved, false if the caller must redraw the rectangle
+*/
+/**************************************************************************/
+bool Adafruit_GFX::scrollRect(int16_t /*x*/, int16_t /*y*/, int16_t /*w*/, int16_t /*h*/, int16_t /*dx*/, int16_t /*dy*/)
+{
+    return false;
+}
+
 /**************************************************************************/
 /*!
    @brief    Draw a line
@@ -1082,299 +1140,984 @@ void Adafruit_GFX::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, uint8_t
     endWrite();
 }
 
-// TEXT- AND CHARACTER-HANDLING FUNCTIONS ----------------------------------
-
-// Draw a character
 /**************************************************************************/
 /*!
-   @brief   Draw a single character
-    @param    x   Bottom left corner x coordinate
-    @param    y   Bottom left corner y coordinate
-    @param    c   The 8-bit font-indexed character (likely ascii)
-    @param    color 16-bit 5-6-5 Color to draw chraracter with
-    @param    bg 16-bit 5-6-5 Color to fill background with (if same as color, no background)
-    @param    size  Font magnification level, 1 is 'original' size
+   @brief   Draw a rectangular region of a larger RAM-resident 16-bit image
+   (RGB 5/6/5) at the specified (x,y) position, e.g. part of a canvas buffer
+   or a sprite from a sheet. For 16-bit display devices; no color reduction
+   performed.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    bitmap  Pointer to the region's top left pixel
+    @param    stride  Distance between rows of the image, in pixels
+    @param    w   Width of region in pixels
+    @param    h   Height of region in pixels
 */
 /**************************************************************************/
-void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+void Adafruit_GFX::drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h)
 {
-    if (!gfxFont)
-    { // 'Classic' built-in font
-
-        if ((x >= _width) ||            // Clip right
-            (y >= _height) ||           // Clip bottom
-            ((x + 6 * size - 1) < 0) || // Clip left
-            ((y + 8 * size - 1) < 0))   // Clip top
-            return;
-
-        if (!_cp437 && (c >= 176))
-            c++; // Handle 'classic' charset behavior
-
-        startWrite();
-        for (int8_t i = 0; i < 5; i++)
-        { // Char bitmap = 5 columns
-            uint8_t line = pgm_read_byte(&font[c * 5 + i]);
-            for (int8_t j = 0; j < 8; j++, line >>= 1)
-            {
-                if (line & 1)
-                {
-                    if (size == 1)
-                        writePixel(x + i, y + j, color);
-                    else
-                        writeFillRect(x + i * size, y + j * size, size, size, color);
-                }
-                else if (bg != color)
-                {
-                    if (size == 1)
-                        writePixel(x + i, y + j, bg);
-                    else
-                        writeFillRect(x + i * size, y + j * size, size, size, bg);
-                }
-            }
-        }
-        if (bg != color)
-        { // If opaque, draw vertical line for last column
-            if (size == 1)
-                writeFastVLine(x + 5, y, 8, bg);
-            else
-                writeFillRect(x + 5 * size, y, size, 8 * size, bg);
-        }
-        endWrite();
-    }
-    else
-    { // Custom font
-
-        // Character is assumed previously filtered by write() to eliminate
-        // newlines, returns, non-printable characters, etc.  Calling
-        // drawChar() directly with 'bad' characters of font may cause mayhem!
-
-        c -= (uint8_t)pgm_read_byte(&gfxFont->first);
-        GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(&gfxFont->glyph))[c]);
-        uint8_t *bitmap = (uint8_t *)pgm_read_pointer(&gfxFont->bitmap);
-
-        uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
-        uint8_t w = pgm_read_byte(&glyph->width),
-                h = pgm_read_byte(&glyph->height);
-        int8_t xo = pgm_read_byte(&glyph->xOffset),
-               yo = pgm_read_byte(&glyph->yOffset);
-        uint8_t xx, yy, bits = 0, bit = 0;
-        int16_t xo16 = 0, yo16 = 0;
-
-        if (size > 1)
+    startWrite();
+    for (int16_t j = 0; j < h; j++, y++, bitmap += stride)
+    {
+        for (int16_t i = 0; i < w; i++)
         {
-            xo16 = xo;
-            yo16 = yo;
+            writePixel(x + i, y, bitmap[i]);
         }
+    }
+    endWrite();
+}
 
-        // Todo: Add character clipping here
-
-        // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
-        // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
-        // has typically been used with the 'classic' font to overwrite old
-        // screen contents with new data.  This ONLY works because the
-        // characters are a uniform size; it's not a sensible thing to do with
-        // proportionally-spaced fonts with glyphs of varying sizes (and that
-        // may overlap).  To replace previously-drawn text when using a custom
-        // font, use the getTextBounds() function to determine the smallest
-        // rectangle encompassing a string, erase the area with fillRect(),
-        // then draw new text.  This WILL infortunately 'blink' the text, but
-        // is unavoidable.  Drawing 'background' pixels will NOT fix this,
-        // only creates a new set of problems.  Have an idea to work around
-        // this (a canvas object type for MCUs that can afford the RAM and
-        // displays supporting setAddrWindow() and pushColors()), but haven't
-        // implemented this yet.
+/**************************************************************************/
+/*!
+   @brief   Draw a 16-bit image (RGB 5/6/5), or a rectangular region of one
+   (e.g. a sprite from a sheet), streamed from external storage. The region
+   is clipped to the image and the display, then drawn by
+   drawImagePreclipped(), which devices may override.
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    image  Stored image, begin() already called
+    @param    sx  Left edge of region within image
+    @param    sy  Top edge of region within image
+    @param    w   Width of region in pixels, -1 for the rest of the image
+    @param    h   Height of region in pixels, -1 for the rest of the image
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawImage(int16_t x, int16_t y, GFXimage &image, int16_t sx, int16_t sy, int16_t w, int16_t h)
+{
+    if (w < 0)
+        w = image.width() - sx;
+    if (h < 0)
+        h = image.height() - sy;
+    if (sx < 0)
+    { // Clip region to image
+        w += sx;
+        x -= sx;
+        sx = 0;
+    }
+    if (sy < 0)
+    {
+        h += sy;
+        y -= sy;
+        sy = 0;
+    }
+    if (sx + w > image.width())
+        w = image.width() - sx;
+    if (sy + h > image.height())
+        h = image.height() - sy;
 
-        startWrite();
-        for (yy = 0; yy < h; yy++)
-        {
-            for (xx = 0; xx < w; xx++)
-            {
-                if (!(bit++ & 7))
-                {
-                    bits = pgm_read_byte(&bitmap[bo++]);
-                }
-                if (bits & 0x80)
-                {
-                    if (size == 1)
-                    {
-                        writePixel(x + xo + xx, y + yo + yy, color);
-                    }
-                    else
-                    {
-                        writeFillRect(x + (xo16 + xx) * size, y + (yo16 + yy) * size, size, size, color);
-                    }
-                }
-                bits <<= 1;
-            }
-        }
-        endWrite();
+    if (x < 0)
+    { // Clip region to display
+        w += x;
+        sx -= x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        sy -= y;
+        y = 0;
+    }
+    if (x + w > _width)
+        w = _width - x;
+    if (y + h > _height)
+        h = _height - y;
 
-    } // End classic vs custom font
+    if ((w > 0) && (h > 0))
+        drawImagePreclipped(x, y, image, sx, sy, w, h);
 }
+
 /**************************************************************************/
 /*!
-    @brief  Print one byte/character of data, used to support print()
-    @param  c  The 8-bit ascii character to write
+   @brief   Draw an already-clipped region of a stored image. Generic version
+   reads a few pixels at a time and issues them with writePixel().
+    @param    x   Top left corner x coordinate, onscreen
+    @param    y   Top left corner y coordinate, onscreen
+    @param    image  Stored image
+    @param    sx  Left edge of region within image
+    @param    sy  Top edge of region within image
+    @param    w   Width of region, region MUST be within image and display
+    @param    h   Height of region, region MUST be within image and display
 */
 /**************************************************************************/
-size_t Adafruit_GFX::write(uint8_t c)
+void Adafruit_GFX::drawImagePreclipped(int16_t x, int16_t y, GFXimage &image, int16_t sx, int16_t sy, int16_t w, int16_t h)
 {
-    if (!gfxFont)
-    { // 'Classic' built-in font
-
-        if (c == '\n')
-        {                             // Newline?
-            cursor_x = 0;             // Reset x to zero,
-            cursor_y += textsize * 8; // advance y one line
-        }
-        else if (c != '\r')
-        { // Ignore carriage returns
-            if (wrap && ((cursor_x + textsize * 6) > _width))
-            {                             // Off right?
-                cursor_x = 0;             // Reset x to zero,
-                cursor_y += textsize * 8; // advance y one line
-            }
-            drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
-            cursor_x += textsize * 6; // Advance x one char
-        }
-    }
-    else
-    { // Custom font
-
-        if (c == '\n')
-        {
-            cursor_x = 0;
-            cursor_y += (int16_t)textsize * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
-        }
-        else if (c != '\r')
+    uint8_t buf[64]; // 32 pixels, big-endian
+    startWrite();
+    for (int16_t j = 0; j < h; j++)
+    {
+        for (int16_t i = 0; i < w; i += sizeof(buf) / 2)
         {
-            uint8_t first = pgm_read_byte(&gfxFont->first);
-            if ((c >= first) && (c <= (uint8_t)pgm_read_byte(&gfxFont->last)))
+            int16_t n = min(w - i, (int16_t)(sizeof(buf) / 2));
+            if (image.read(buf, sx + i, sy + j, n))
             {
-                GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(
-                    &gfxFont->glyph))[c - first]);
-                uint8_t w = pgm_read_byte(&glyph->width),
-                        h = pgm_read_byte(&glyph->height);
-                if ((w > 0) && (h > 0))
-                {                                                        // Is there an associated bitmap?
-                    int16_t xo = (int8_t)pgm_read_byte(&glyph->xOffset); // sic
-                    if (wrap && ((cursor_x + textsize * (xo + w)) > _width))
-                    {
-                        cursor_x = 0;
-                        cursor_y += (int16_t)textsize * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
-                    }
-                    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
-                }
-                cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance) * (int16_t)textsize;
+                endWrite();
+                return; // Storage error, give up on the image
             }
+            for (int16_t k = 0; k < n; k++)
+                writePixel(x + i + k, y + j, (buf[2 * k] << 8) | buf[2 * k + 1]);
         }
     }
-    return 1;
-}
-
-int Adafruit_GFX::_putc(int value)
-{
-    write((uint8_t)value);
-    return value;
-}
-
-int Adafruit_GFX::_getc()
-{
-    return -1;
-}
-
-void Adafruit_GFX::print(char *str)
-{
-    printf(str);
+    endWrite();
 }
 
 /**************************************************************************/
 /*!
-    @brief  Set text cursor location
-    @param  x    X coordinate in pixels
-    @param  y    Y coordinate in pixels
+   @brief   Make an affine map that rotates and scales an image about a
+   pivot point, for drawRGBBitmapTransformed() (e.g. a gauge needle turning
+   about its hub, or an icon spun about its center).
+    @param    m       Map, filled in
+    @param    degrees Rotation, clockwise
+    @param    scale   Magnification (0.5 = half size); 0 or less draws
+                      nothing
+    @param    pivotX  Pivot point in the image, in pixels from its left
+                      edge (w / 2 for the center)
+    @param    pivotY  Pivot point in the image, in pixels from its top edge
+    @param    x       Where the pivot point goes on the display
+    @param    y       Where the pivot point goes on the display
 */
 /**************************************************************************/
-void Adafruit_GFX::setCursor(int16_t x, int16_t y)
+void gfxAffineRotate(GFXaffine *m, float degrees, float scale, float pivotX, float pivotY, int16_t x, int16_t y)
 {
-    cursor_x = x;
-    cursor_y = y;
+    float a = degrees * 3.14159265f / 180, k = (scale > 0) ? 65536 / scale : 0;
+    float cs = cosf(a) * k, sn = sinf(a) * k;
+    float dx = 0.5f - x, dy = 0.5f - y; // Sample at destination pixel centers
+    m->a = (int32_t)floorf(cs + 0.5f);
+    m->b = (int32_t)floorf(sn + 0.5f);
+    m->tx = (int32_t)floorf(pivotX * 65536 + cs * dx + sn * dy + 0.5f);
+    m->c = -m->b;
+    m->d = m->a;
+    m->ty = (int32_t)floorf(pivotY * 65536 - sn * dx + cs * dy + 0.5f);
 }
 
 /**************************************************************************/
 /*!
-    @brief  Get text cursor X location
-    @returns    X coordinate in pixels
+   @brief   Draw a RAM-resident 16-bit image (RGB 5/6/5) through an affine
+   map: rotated, scaled, sheared or flipped, sampled at the nearest pixel.
+   The destination area is bounded by the image's corners and clipped, then
+   drawn by drawRGBBitmapTransformedPreclipped(), which devices may
+   override; each row walks the source in fixed point over exactly the span
+   that falls within the image.
+    @param    bitmap  w * h pixels
+    @param    w       Image width, under 32768
+    @param    h       Image height, under 32768
+    @param    m       Map from display to image positions
+    @param    mask    1 bit per pixel, rows padded to bytes (as for
+                      drawRGBBitmap()); set bits are drawn. NULL if none
+    @param    clip    Display area to keep to, or NULL for the whole screen
 */
 /**************************************************************************/
-int16_t Adafruit_GFX::getCursorX(void) const
+void Adafruit_GFX::drawRGBBitmapTransformed(const uint16_t *bitmap, int16_t w, int16_t h, const GFXaffine &m, const uint8_t *mask, const GFXrect *clip)
 {
-    return cursor_x;
+    GFXrect area = {0, 0, _width, _height};
+    if (clip)
+        area = *clip;
+    if (bitmap && (w > 0) && (h > 0) && clipRect(&area.x, &area.y, &area.w, &area.h) && affineBounds(m, w, h, &area))
+        drawRGBBitmapTransformedPreclipped(bitmap, mask, w, h, m, area);
 }
 
 /**************************************************************************/
 /*!
-    @brief      Get text cursor Y location
-    @returns    Y coordinate in pixels
+   @brief   Draw an image through an affine map, within an already-clipped
+   area. Generic version issues each pixel with writePixel().
+    @param    bitmap  w * h pixels
+    @param    mask    1 bit per pixel (see drawRGBBitmapTransformed()), or
+                      NULL
+    @param    w       Image width
+    @param    h       Image height
+    @param    m       Map from display to image positions
+    @param    area    Display area to draw in, MUST be onscreen
 */
 /**************************************************************************/
-int16_t Adafruit_GFX::getCursorY(void) const
+void Adafruit_GFX::drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area)
 {
-    return cursor_y;
+    int16_t maskStride = (w + 7) / 8;
+    startWrite();
+    for (int16_t y = area.y; y < area.y + area.h; y++)
+    {
+        int16_t x0 = area.x, x1 = area.x + area.w - 1;
+        int32_t u, v;
+        if (!affineSpan(m, w, h, y, &x0, &x1, &u, &v))
+            continue;
+        for (int16_t x = x0; x <= x1; x++, u += m.a, v += m.c)
+        {
+            int16_t su = u >> 16, sv = v >> 16;
+            if (!mask || (pgm_read_byte(&mask[sv * maskStride + su / 8]) & (0x80 >> (su & 7))))
+                writePixel(x, y, pgm_read_word(&bitmap[sv * w + su]));
+        }
+    }
+    endWrite();
 }
 
+// TEXT- AND CHARACTER-HANDLING FUNCTIONS ----------------------------------
+
+// Draw a character
 /**************************************************************************/
 /*!
-    @brief   Set text 'magnification' size. Each increase in s makes 1 pixel that much bigger.
-    @param  s  Desired text size. 1 is default 6x8, 2 is 12x16, 3 is 18x24, etc
+   @brief   Draw a single character
+    @param    x   Bottom left corner x coordinate
+    @param    y   Bottom left corner y coordinate
+    @param    c   The 8-bit font-indexed character (likely ascii)
+    @param    color 16-bit 5-6-5 Color to draw chraracter with
+    @param    bg 16-bit 5-6-5 Color to fill background with (if same as color, no background)
+    @param    size  Font magnification level, 1 is 'original' size
 */
 /**************************************************************************/
-void Adafruit_GFX::setTextSize(uint8_t s)
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
 {
-    textsize = (s > 0) ? s : 1;
+    drawChar(x, y, c, color, bg, size, size);
 }
 
+// Draw a character
 /**************************************************************************/
 /*!
-    @brief   Set text font color with transparant background
-    @param   c   16-bit 5-6-5 Color to draw text with
+   @brief   Draw a single character
+    @param    x   Bottom left corner x coordinate
+    @param    y   Bottom left corner y coordinate
+    @param    c   The 8-bit font-indexed character (likely ascii)
+    @param    color 16-bit 5-6-5 Color to draw chraracter with
+    @param    bg 16-bit 5-6-5 Color to fill background with (if same as color, no background)
+    @param    size_x  Font magnification level in X-axis, 1 is 'original' size
+    @param    size_y  Font magnification level in Y-axis, 1 is 'original' size
 */
 /**************************************************************************/
-void Adafruit_GFX::setTextColor(uint16_t c)
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
 {
-    // For 'transparent' background, we'll set the bg
-    // to the same as fg instead of using a flag
-    textcolor = textbgcolor = c;
+    drawChar(ctx, x, y, c, color, bg, size_x, size_y);
 }
 
 /**************************************************************************/
 /*!
-    @brief   Set text font color with custom background color
-    @param   c   16-bit 5-6-5 Color to draw text with
-    @param   b   16-bit 5-6-5 Color to draw background/fill with
+   @brief   Draw a single character in the font of a drawing context
+    @param    ctx Drawing context supplying the font and charset
+    @param    x   Bottom left corner x coordinate
+    @param    y   Bottom left corner y coordinate
+    @param    c   The 8-bit font-indexed character (likely ascii)
+    @param    color 16-bit 5-6-5 Color to draw chraracter with
+    @param    bg 16-bit 5-6-5 Color to fill background with (if same as color, no background)
+    @param    size_x  Font magnification level in X-axis, 1 is 'original' size
+    @param    size_y  Font magnification level in Y-axis, 1 is 'original' size
 */
 /**************************************************************************/
-void Adafruit_GFX::setTextColor(uint16_t c, uint16_t b)
+void Adafruit_GFX::drawChar(const GFXcontext &ctx, int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
 {
-    textcolor = c;
-    textbgcolor = b;
+    if (ctx.streamFont)
+    { // Streamed font, glyph comes from the font's RAM cache
+        const uint8_t *bitmap;
+        const GFXglyph *glyph = ctx.streamFont->getGlyph(c, &bitmap);
+        if (glyph)
+            drawGlyph(x, y, glyph, bitmap, color, size_x, size_y);
+    }
+    else if (!ctx.gfxFont)
+    { // 'Classic' built-in font
+        if (!ctx._cp437 && (c >= 176))
+            c++; // Handle 'classic' charset behavior
+        drawClassicChar(x, y, c, color, bg, size_x, size_y);
+    }
+    else
+    { // Custom font
+
+        // Character is assumed previously filtered by write() to eliminate
+        // newlines, returns, non-printable characters, etc.  Calling
+        // drawChar() directly with 'bad' characters of font may cause mayhem!
+
+        c -= (uint8_t)pgm_read_byte(&ctx.gfxFont->first);
+        GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(&ctx.gfxFont->glyph))[c]);
+        uint8_t *bitmap = (uint8_t *)pgm_read_pointer(&ctx.gfxFont->bitmap);
+
+        GFXglyph g; // Metrics copied out of PROGMEM
+        g.bitmapOffset = 0;
+        g.width = pgm_read_byte(&glyph->width);
+        g.height = pgm_read_byte(&glyph->height);
+        g.xAdvance = pgm_read_byte(&glyph->xAdvance);
+        g.xOffset = pgm_read_byte(&glyph->xOffset);
+        g.yOffset = pgm_read_byte(&glyph->yOffset);
+        drawGlyph(x, y, &g, &bitmap[pgm_read_word(&glyph->bitmapOffset)], color, size_x, size_y);
+    } // End classic vs custom font
 }
 
 /**************************************************************************/
 /*!
-    @brief      Whether text that is too long should 'wrap' around to the next line.
-    @param  w Set true for wrapping, false for clipping
+   @brief   Draw a single character of the 'classic' built-in 6x8 font,
+            already adjusted for the CP437 setting. Devices MAY override
+            this to push whole character cells (see Adafruit_SPITFT).
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    c   Index into the built-in font
+    @param    color 16-bit 5-6-5 Color to draw chraracter with
+    @param    bg 16-bit 5-6-5 Color to fill background with (if same as color, no background)
+    @param    size_x  Font magnification level in X-axis, 1 is 'original' size
+    @param    size_y  Font magnification level in Y-axis, 1 is 'original' size
 */
 /**************************************************************************/
-void Adafruit_GFX::setTextWrap(boolean w)
+void Adafruit_GFX::drawClassicChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
 {
-    wrap = w;
+    if ((x >= _width) ||              // Clip right
+        (y >= _height) ||             // Clip bottom
+        ((x + 6 * size_x - 1) < 0) || // Clip left
+        ((y + 8 * size_y - 1) < 0))   // Clip top
+        return;
+
+    // Visible column (0-5) and row (0-7) range of the character cell,
+    // so partially offscreen characters only touch onscreen pixels.
+    int16_t i0, j0, i1, j1;
+    charClip(x, y, 6, 8, size_x, size_y, &i0, &j0, &i1, &j1);
+
+    startWrite();
+    for (int16_t i = i0; (i <= i1) && (i < 5); i++)
+    { // Char bitmap = 5 columns
+        uint8_t line = pgm_read_byte(&font[c * 5 + i]) >> j0;
+        for (int16_t j = j0; j <= j1; j++, line >>= 1)
+        {
+            if (line & 1)
+            {
+                if (size_x == 1 && size_y == 1)
+                    writePixel(x + i, y + j, color);
+                else
+                    writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);
+            }
+            else if (bg != color)
+            {
+                if (size_x == 1 && size_y == 1)
+                    writePixel(x + i, y + j, bg);
+                else
+                    writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+            }
+        }
+    }
+    if ((bg != color) && (i1 == 5))
+    { // If opaque, draw vertical line for last column
+        if (size_x == 1 && size_y == 1)
+            writeFastVLine(x + 5, y, 8, bg);
+        else
+            writeFillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);
+    }
+    endWrite();
 }
 
 /**************************************************************************/
 /*!
-    @brief      Get rotation setting for display
-    @returns    0 thru 3 corresponding to 4 cardinal rotations
+    @brief   Draw a single glyph of a custom (GFXfont or streamed) font. All
+            custom-font text ends up here, so devices can override this to
+            optimize proportional text.
+    @param    x   Cursor x coordinate (glyph offsets are relative to this)
+    @param    y   Cursor y coordinate, on the baseline
+    @param    glyph   Glyph metrics, RAM-resident (bitmapOffset is ignored)
+    @param    bitmap  This glyph's bitmap (first byte)
+    @param    color 16-bit 5-6-5 Color to draw glyph with
+    @param    size_x  Font magnification level in X-axis, 1 is 'original' size
+    @param    size_y  Font magnification level in Y-axis, 1 is 'original' size
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint16_t color, uint8_t size_x, uint8_t size_y)
+{
+    uint8_t w = glyph->width,
+            h = glyph->height;
+    int8_t xo = glyph->xOffset,
+           yo = glyph->yOffset;
+    uint8_t bits = 0;
+    int16_t xo16 = 0, yo16 = 0;
+
+    if (size_x > 1 || size_y > 1)
+    {
+        xo16 = xo;
+        yo16 = yo;
+    }
+
+    if (!w || !h)
+        return; // Nothing to draw (e.g. space)
+
+    // Character clipping: find the range of glyph columns and rows
+    // that land onscreen (each is size_x by size_y pixels). Glyphs
+    // entirely offscreen are rejected before any bitmap is decoded,
+    // rows above/below the screen are skipped outright, and columns
+    // are clipped once per glyph rather than once per pixel.
+    int16_t xs, ys, xe, ye;
+    if (!charClip(x + xo * size_x, y + yo * size_y, w, h, size_x, size_y, &xs, &ys, &xe, &ye))
+        return; // Fully clipped
+
+    // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
+    // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
+    // has typically been used with the 'classic' font to overwrite old
+    // screen contents with new data.  This ONLY works because the
+    // characters are a uniform size; it's not a sensible thing to do with
+    // proportionally-spaced fonts with glyphs of varying sizes (and that
+    // may overlap).  To replace previously-drawn text when using a custom
+    // font, use the getTextBounds() function to determine the smallest
+    // rectangle encompassing a string, erase the area with fillRect(),
+    // then draw new text.  This WILL infortunately 'blink' the text, but
+    // is unavoidable.  Drawing 'background' pixels will NOT fix this,
+    // only creates a new set of problems.  Have an idea to work around
+    // this (a canvas object type for MCUs that can afford the RAM and
+    // displays supporting setAddrWindow() and pushColors()), but haven't
+    // implemented this yet.
+
+    startWrite();
+    for (int16_t yy = ys; yy <= ye; yy++)
+    {
+        // Glyph bitmaps are a continuous bitstream (rows are not byte
+        // padded), so seek straight to the first visible bit of the row.
+        uint16_t bit = yy * w + xs;
+        bits = pgm_read_byte(&bitmap[bit >> 3]) << (bit & 7);
+        for (int16_t xx = xs; xx <= xe; xx++, bit++)
+        {
+            if (!(bit & 7))
+            {
+                bits = pgm_read_byte(&bitmap[bit >> 3]);
+            }
+            if (bits & 0x80)
+            {
+                if (size_x == 1 && size_y == 1)
+                {
+                    writePixel(x + xo + xx, y + yo + yy, color);
+                }
+                else
+                {
+                    writeFillRect(x + (xo16 + xx) * size_x, y + (yo16 + yy) * size_y, size_x, size_y, color);
+                }
+            }
+            bits <<= 1;
+        }
+    }
+    endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief    Helper to find which cells of a character or glyph bitmap land
+              onscreen. Shared by drawChar() and its subclass overrides so
+              clipping is done once per glyph rather than once per pixel.
+    @param    px    Screen X of the bitmap's upper-left corner
+    @param    py    Screen Y of the bitmap's upper-left corner
+    @param    w     Bitmap width in cells
+    @param    h     Bitmap height in cells
+    @param    size_x  Horizontal magnification; each cell is size_x pixels wide
+    @param    size_y  Vertical magnification; each cell is size_y pixels tall
+    @param    x0    First visible column, set by function
+    @param    y0    First visible row, set by function
+    @param    x1    Last visible column (inclusive), set by function
+    @param    y1    Last visible row (inclusive), set by function
+    @returns  False if no part of the bitmap is onscreen
+*/
+/**************************************************************************/
+bool Adafruit_GFX::charClip(int16_t px, int16_t py, int16_t w, int16_t h, uint8_t size_x, uint8_t size_y, int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1)
+{
+    *x0 = (px < 0) ? (-px / size_x) : 0;
+    *y0 = (py < 0) ? (-py / size_y) : 0;
+    *x1 = (px < _width) ? ((_width - px - 1) / size_x) : -1;
+    *y1 = (py < _height) ? ((_height - py - 1) / size_y) : -1;
+    if (*x1 >= w)
+        *x1 = w - 1;
+    if (*y1 >= h)
+        *y1 = h - 1;
+    return (*x0 <= *x1) && (*y0 <= *y1);
+}
+
+/**************************************************************************/
+/*!
+    @brief    Fetch one column of the 'classic' 5x8 built-in font. Lets
+              subclasses with their own text rendering share the font table
+              (which is static to this file) rather than linking a copy.
+    @param    c    The 8-bit font-indexed character, after any CP437 fixup
+    @param    col  Column number, 0 to 4
+    @returns  Column bitmap, LSB = top row
+*/
+/**************************************************************************/
+uint8_t Adafruit_GFX::classicFontColumn(unsigned char c, uint8_t col) const
+{
+    return pgm_read_byte(&font[c * 5 + col]);
+}
+
+/**************************************************************************/
+/*!
+    @brief    Convert a rectangle at the current rotation to unrotated
+              (rotation 0) coordinates, for subclasses that pass whole
+              rectangles on to other devices rather than single pixels.
+              Negative sizes are flipped; no clipping is done.
+    @param    x    Left edge, converted in place
+    @param    y    Top edge, converted in place
+    @param    w    Width, converted in place
+    @param    h    Height, converted in place
+    @returns  False if the rectangle is empty
+*/
+/**************************************************************************/
+bool Adafruit_GFX::rotateRect(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const
+{
+    if (*w < 0)
+    {
+        *x += *w + 1;
+        *w = -*w;
+    }
+    if (*h < 0)
+    {
+        *y += *h + 1;
+        *h = -*h;
+    }
+    if (!*w || !*h)
+        return false;
+
+    int16_t t;
+    switch (rotation)
+    {
+    case 1:
+        t = *x;
+        *x = WIDTH - *y - *h;
+        *y = t;
+        t = *w;
+        *w = *h;
+        *h = t;
+        break;
+    case 2:
+        *x = WIDTH - *x - *w;
+        *y = HEIGHT - *y - *h;
+        break;
+    case 3:
+        t = *y;
+        *y = HEIGHT - *x - *w;
+        *x = t;
+        t = *w;
+        *w = *h;
+        *h = t;
+        break;
+    }
+    return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief    Clip a rectangle to the screen at the current rotation.
+    @param    x    Left edge, clipped in place
+    @param    y    Top edge, clipped in place
+    @param    w    Width, clipped in place
+    @param    h    Height, clipped in place
+    @returns  False if nothing is left (zero or negative sizes included)
+*/
+/**************************************************************************/
+bool Adafruit_GFX::clipRect(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const
+{
+    if ((*w <= 0) || (*h <= 0) || (*x >= _width) || (*y >= _height))
+        return false;
+    int16_t x2 = *x + *w, y2 = *y + *h; // Exclusive
+    if ((x2 <= 0) || (y2 <= 0))
+        return false;
+    if (*x < 0)
+        *x = 0;
+    if (*y < 0)
+        *y = 0;
+    *w = ((x2 > _width) ? _width : x2) - *x;
+    *h = ((y2 > _height) ? _height : y2) - *y;
+    return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief    Convert an 8x8 pattern anchored at the screen origin at the
+              current rotation to one anchored at the unrotated origin, so
+              canvases can fill whole unrotated rows from it.
+    @param    pattern  8 rows, MSB = left pixel
+    @param    raw      Unrotated pattern (row = unrotated y mod 8, MSB =
+                       unrotated x mod 8 of 0)
+*/
+/**************************************************************************/
+void Adafruit_GFX::rotatePattern(const uint8_t pattern[8], uint8_t raw[8]) const
+{
+    for (int16_t ry = 0; ry < 8; ry++)
+    {
+        uint8_t bits = 0;
+        for (int16_t rx = 0; rx < 8; rx++)
+        {
+            int16_t x, y; // Rotated coordinates, mod 8
+            switch (rotation)
+            {
+            case 1:
+                x = ry;
+                y = WIDTH - 1 - rx;
+                break;
+            case 2:
+                x = WIDTH - 1 - rx;
+                y = HEIGHT - 1 - ry;
+                break;
+            case 3:
+                x = HEIGHT - 1 - ry;
+                y = rx;
+                break;
+            default:
+                x = rx;
+                y = ry;
+                break;
+            }
+            if (pattern[y & 7] & (0x80 >> (x & 7)))
+                bits |= 0x80 >> rx;
+        }
+        raw[ry] = bits;
+    }
+}
+
+// Division rounding down or up; d MUST be positive
+static inline int64_t floorDiv(int64_t n, int64_t d)
+{
+    return (n >= 0) ? n / d : -((d - 1 - n) / d);
+}
+
+static inline int64_t ceilDiv(int64_t n, int64_t d)
+{
+    return -floorDiv(-n, d);
+}
+
+// Narrow [*lo, *hi] to the x where 0 <= p0 + dp * x <= top
+static bool spanLimit(int64_t p0, int32_t dp, int64_t top, int64_t *lo, int64_t *hi)
+{
+    int64_t l = *lo, h = *hi;
+    if (dp > 0)
+    {
+        l = ceilDiv(-p0, dp);
+        h = floorDiv(top - p0, dp);
+    }
+    else if (dp < 0)
+    {
+        l = ceilDiv(p0 - top, -dp);
+        h = floorDiv(p0, -dp);
+    }
+    else if ((p0 < 0) || (p0 > top))
+    {
+        return false;
+    }
+    if (l > *lo)
+        *lo = l;
+    if (h < *hi)
+        *hi = h;
+    return *lo <= *hi;
+}
+
+/**************************************************************************/
+/*!
+    @brief    Shrink an area to the part an affine-mapped image may cover:
+              the bounding box of the image's corners, mapped back to the
+              display.
+    @param    m     Map from display to image positions
+    @param    w     Image width
+    @param    h     Image height
+    @param    area  Clipped area, shrunk in place
+    @returns  false if nothing is left (or the map is degenerate)
+*/
+/**************************************************************************/
+bool Adafruit_GFX::affineBounds(const GFXaffine &m, int16_t w, int16_t h, GFXrect *area) const
+{
+    int64_t det = (int64_t)m.a * m.d - (int64_t)m.b * m.c, x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+    if (!det)
+        return false;
+    for (uint8_t k = 0; k < 4; k++)
+    {
+        int64_t du = ((k & 1) ? (int64_t)w << 16 : 0) - m.tx, dv = ((k & 2) ? (int64_t)h << 16 : 0) - m.ty;
+        int64_t nx = m.d * du - m.b * dv, ny = m.a * dv - m.c * du; // Corner * det
+        if (det < 0)
+        {
+            nx = -nx;
+            ny = -ny;
+        }
+        if (!k || (nx < x0))
+            x0 = nx;
+        if (!k || (nx > x1))
+            x1 = nx;
+        if (!k || (ny < y0))
+            y0 = ny;
+        if (!k || (ny > y1))
+            y1 = ny;
+    }
+    if (det < 0)
+        det = -det;
+    // A pixel either side for rounding; rows are then spanned exactly
+    x0 = floorDiv(x0, det) - 1;
+    x1 = floorDiv(x1, det) + 1;
+    y0 = floorDiv(y0, det) - 1;
+    y1 = floorDiv(y1, det) + 1;
+    if (x0 < area->x)
+        x0 = area->x;
+    if (x1 > area->x + area->w - 1)
+        x1 = area->x + area->w - 1;
+    if (y0 < area->y)
+        y0 = area->y;
+    if (y1 > area->y + area->h - 1)
+        y1 = area->y + area->h - 1;
+    if ((x0 > x1) || (y0 > y1))
+        return false;
+    area->x = x0;
+    area->y = y0;
+    area->w = x1 - x0 + 1;
+    area->h = y1 - y0 + 1;
+    return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief    Find the span of a display row whose affine-mapped positions
+              fall within an image, and the image position at its start.
+    @param    m   Map from display to image positions
+    @param    w   Image width
+    @param    h   Image height
+    @param    y   Display row
+    @param    x0  First column to consider, raised to the span's start
+    @param    x1  Last column to consider, lowered to the span's end
+    @param    u   Image column at x0, 16.16 fixed point (step m.a)
+    @param    v   Image row at x0, 16.16 fixed point (step m.c)
+    @returns  false if the row misses the image
+*/
+/**************************************************************************/
+bool Adafruit_GFX::affineSpan(const GFXaffine &m, int16_t w, int16_t h, int16_t y, int16_t *x0, int16_t *x1, int32_t *u, int32_t *v) const
+{
+    int64_t u0 = (int64_t)m.b * y + m.tx, v0 = (int64_t)m.d * y + m.ty; // At x = 0
+    int64_t lo = *x0, hi = *x1;
+    if (!spanLimit(u0, m.a, ((int64_t)w << 16) - 1, &lo, &hi) || !spanLimit(v0, m.c, ((int64_t)h << 16) - 1, &lo, &hi))
+        return false;
+    *x0 = lo;
+    *x1 = hi;
+    *u = u0 + m.a * lo;
+    *v = v0 + m.c * lo;
+    return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Print one byte/character of data, used to support print()
+    @param  c  The 8-bit ascii character to write
+*/
+/**************************************************************************/
+size_t Adafruit_GFX::write(uint8_t c)
+{
+    return write(ctx, c);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Print one byte/character of data using, and advancing the
+            cursor of, a drawing context rather than the device's own
+    @param  ctx  Drawing context (cursor, colors, size, font...)
+    @param  c  The 8-bit ascii character to write
+    @returns  1
+*/
+/**************************************************************************/
+size_t Adafruit_GFX::write(GFXcontext &ctx, uint8_t c)
+{
+    if (ctx.streamFont)
+    { // Streamed font
+        uint16_t code = c;
+        if (ctx.streamFont->isUnicode())
+        { // Multi-byte characters are UTF-8
+            if (!GFXstreamFont::decodeUTF8(c, &ctx.utf8_code, &ctx.utf8_left))
+                return 1;
+            code = ctx.utf8_code;
+        }
+
+        if (code == '\n')
+        {
+            ctx.cursor_x = 0;
+            ctx.cursor_y += (int16_t)ctx.textsize_y * ctx.streamFont->yAdvance();
+        }
+        else if (code != '\r')
+        {
+            const uint8_t *bitmap;
+            const GFXglyph *glyph = ctx.streamFont->getGlyph(code, &bitmap);
+            if (glyph)
+            {
+                if ((glyph->width > 0) && (glyph->height > 0))
+                { // Is there an associated bitmap?
+                    if (ctx.wrap && ((ctx.cursor_x + ctx.textsize_x * (glyph->xOffset + glyph->width)) > _width))
+                    {
+                        ctx.cursor_x = 0;
+                        ctx.cursor_y += (int16_t)ctx.textsize_y * ctx.streamFont->yAdvance();
+                    }
+                    drawGlyph(ctx.cursor_x, ctx.cursor_y, glyph, bitmap, ctx.textcolor, ctx.textsize_x, ctx.textsize_y);
+                }
+                ctx.cursor_x += glyph->xAdvance * (int16_t)ctx.textsize_x;
+            }
+        }
+    }
+    else if (!ctx.gfxFont)
+    { // 'Classic' built-in font
+
+        if (c == '\n')
+        {                             // Newline?
+            ctx.cursor_x = 0;               // Reset x to zero,
+            ctx.cursor_y += ctx.textsize_y * 8; // advance y one line
+        }
+        else if (c != '\r')
+        { // Ignore carriage returns
+            if (ctx.wrap && ((ctx.cursor_x + ctx.textsize_x * 6) > _width))
+            {                               // Off right?
+                ctx.cursor_x = 0;               // Reset x to zero,
+                ctx.cursor_y += ctx.textsize_y * 8; // advance y one line
+            }
+            drawChar(ctx, ctx.cursor_x, ctx.cursor_y, c, ctx.textcolor, ctx.textbgcolor, ctx.textsize_x, ctx.textsize_y);
+            ctx.cursor_x += ctx.textsize_x * 6; // Advance x one char
+        }
+    }
+    else
+    { // Custom font
+
+        if (c == '\n')
+        {
+            ctx.cursor_x = 0;
+            ctx.cursor_y += (int16_t)ctx.textsize_y * (uint8_t)pgm_read_byte(&ctx.gfxFont->yAdvance);
+        }
+        else if (c != '\r')
+        {
+            uint8_t first = pgm_read_byte(&ctx.gfxFont->first);
+            if ((c >= first) && (c <= (uint8_t)pgm_read_byte(&ctx.gfxFont->last)))
+            {
+                GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(
+                    &ctx.gfxFont->glyph))[c - first]);
+                uint8_t w = pgm_read_byte(&glyph->width),
+                        h = pgm_read_byte(&glyph->height);
+                if ((w > 0) && (h > 0))
+                {                                                        // Is there an associated bitmap?
+                    int16_t xo = (int8_t)pgm_read_byte(&glyph->xOffset); // sic
+                    if (ctx.wrap && ((ctx.cursor_x + ctx.textsize_x * (xo + w)) > _width))
+                    {
+                        ctx.cursor_x = 0;
+                        ctx.cursor_y += (int16_t)ctx.textsize_y * (uint8_t)pgm_read_byte(&ctx.gfxFont->yAdvance);
+                    }
+                    drawChar(ctx, ctx.cursor_x, ctx.cursor_y, c, ctx.textcolor, ctx.textbgcolor, ctx.textsize_x, ctx.textsize_y);
+                }
+                ctx.cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance) * (int16_t)ctx.textsize_x;
+            }
+        }
+    }
+    return 1;
+}
+
+int Adafruit_GFX::_putc(int value)
+{
+    write((uint8_t)value);
+    return value;
+}
+
+int Adafruit_GFX::_getc()
+{
+    return -1;
+}
+
+void Adafruit_GFX::print(char *str)
+{
+    if (ctx.streamFont) // Read all of the string's glyphs before drawing
+        ctx.streamFont->prefetch(str);
+    printf(str);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Print a string (no formatting) using a drawing context rather
+            than the device's own. Contexts are independent, so threads may
+            print to different devices or canvases, each with its own
+            context, without sharing any text state. A device itself is not
+            thread-safe (a SPITFT display shares its bus, transaction state
+            and staging buffer), so drawing to one from several threads
+            needs external locking.
+    @param  ctx  Drawing context (cursor, colors, size, font...)
+    @param  str  The string to print
+*/
+/**************************************************************************/
+void Adafruit_GFX::print(GFXcontext &ctx, const char *str)
+{
+    if (ctx.streamFont) // Read all of the string's glyphs before drawing
+        ctx.streamFont->prefetch(str);
+    while (*str)
+        write(ctx, *str++);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set text cursor location
+    @param  x    X coordinate in pixels
+    @param  y    Y coordinate in pixels
+*/
+/**************************************************************************/
+void Adafruit_GFX::setCursor(int16_t x, int16_t y)
+{
+    ctx.setCursor(x, y);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Get text cursor X location
+    @returns    X coordinate in pixels
+*/
+/**************************************************************************/
+int16_t Adafruit_GFX::getCursorX(void) const
+{
+    return ctx.cursor_x;
+}
+
+/**************************************************************************/
+/*!
+    @brief      Get text cursor Y location
+    @returns    Y coordinate in pixels
+*/
+/**************************************************************************/
+int16_t Adafruit_GFX::getCursorY(void) const
+{
+    return ctx.cursor_y;
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text 'magnification' size. Each increase in s makes 1 pixel that much bigger.
+    @param  s  Desired text size. 1 is default 6x8, 2 is 12x16, 3 is 18x24, etc
+*/
+/**************************************************************************/
+void Adafruit_GFX::setTextSize(uint8_t s)
+{
+    ctx.setTextSize(s);
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text 'magnification' size. Each increase in s makes 1 pixel that much bigger.
+    @param  s_x  Desired text width magnification level in X-axis. 1 is default
+    @param  s_y  Desired text width magnification level in Y-axis. 1 is default
+*/
+/**************************************************************************/
+void Adafruit_GFX::setTextSize(uint8_t s_x, uint8_t s_y)
+{
+    ctx.setTextSize(s_x, s_y);
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text font color with transparant background
+    @param   c   16-bit 5-6-5 Color to draw text with
+*/
+/**************************************************************************/
+void Adafruit_GFX::setTextColor(uint16_t c)
+{
+    ctx.setTextColor(c);
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text font color with custom background color
+    @param   c   16-bit 5-6-5 Color to draw text with
+    @param   b   16-bit 5-6-5 Color to draw background/fill with
+*/
+/**************************************************************************/
+void Adafruit_GFX::setTextColor(uint16_t c, uint16_t b)
+{
+    ctx.setTextColor(c, b);
+}
+
+/**************************************************************************/
+/*!
+    @brief      Whether text that is too long should 'wrap' around to the next line.
+    @param  w Set true for wrapping, false for clipping
+*/
+/**************************************************************************/
+void Adafruit_GFX::setTextWrap(boolean w)
+{
+    ctx.setTextWrap(w);
+}
+
+/**************************************************************************/
+/*!
+    @brief      Get rotation setting for display
+    @returns    0 thru 3 corresponding to 4 cardinal rotations
 */
 /**************************************************************************/
 uint8_t Adafruit_GFX::getRotation(void) const
@@ -1418,41 +2161,41 @@ void Adafruit_GFX::setRotation(uint8_t x)
     @param  x  Whether to enable (True) or not (False)
 */
 /**************************************************************************/
-void Adafruit_GFX::cp437(boolean x)
+void Adafruit_GFX::cp437(boolean x)
+{
+    ctx.cp437(x);
+}
+
+/**************************************************************************/
+/*!
+    @brief Set the font to display when print()ing, either custom or default
+    @param  f  The GFXfont object, if NULL use built in 6x8 font
+*/
+/**************************************************************************/
+void Adafruit_GFX::setFont(const GFXfont *f)
 {
-    _cp437 = x;
+    ctx.setFont(f);
 }
 
 /**************************************************************************/
 /*!
-    @brief Set the font to display when print()ing, either custom or default
-    @param  f  The GFXfont object, if NULL use built in 6x8 font
+    @brief Set a streamed font (glyphs read from external storage through
+    a RAM cache) to display when print()ing. Behaves like a custom GFXfont
+    otherwise; setFont() switches back to a GFXfont or the built-in font.
+    @param  f  The GFXstreamFont object, begin() already called. If NULL use
+    built in 6x8 font
 */
 /**************************************************************************/
-void Adafruit_GFX::setFont(const GFXfont *f)
+void Adafruit_GFX::setStreamFont(GFXstreamFont *f)
 {
-    if (f)
-    { // Font struct pointer passed in?
-        if (!gfxFont)
-        { // And no current font struct?
-            // Switching from classic to new font behavior.
-            // Move cursor pos down 6 pixels so it's on baseline.
-            cursor_y += 6;
-        }
-    }
-    else if (gfxFont)
-    { // NULL passed.  Current font struct defined?
-        // Switching from new to classic font behavior.
-        // Move cursor pos up 6 pixels so it's at top-left of char.
-        cursor_y -= 6;
-    }
-    gfxFont = (GFXfont *)f;
+    ctx.setStreamFont(f);
 }
 
 /**************************************************************************/
 /*!
     @brief    Helper to determine size of a character with current font/size.
        Broke this out as it's used by both the PROGMEM- and RAM-resident getTextBounds() functions.
+    @param    ctx   Drawing context supplying font, size and wrap setting
     @param    c     The ascii character in question
     @param    x     Pointer to x location of character
     @param    y     Pointer to y location of character
@@ -1462,39 +2205,40 @@ void Adafruit_GFX::setFont(const GFXfont *f)
     @param    maxy  Maximum clipping value for Y
 */
 /**************************************************************************/
-void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy)
+void Adafruit_GFX::charBounds(const GFXcontext &ctx, char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy)
 {
-    if (gfxFont)
+    if (ctx.gfxFont)
     {
 
         if (c == '\n')
         {           // Newline?
             *x = 0; // Reset x to zero, advance y by one line
-            *y += textsize * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+            *y += ctx.textsize_y * (uint8_t)pgm_read_byte(&ctx.gfxFont->yAdvance);
         }
         else if (c != '\r')
         { // Not a carriage return; is normal char
-            uint8_t first = pgm_read_byte(&gfxFont->first),
-                    last = pgm_read_byte(&gfxFont->last);
+            uint8_t first = pgm_read_byte(&ctx.gfxFont->first),
+                    last = pgm_read_byte(&ctx.gfxFont->last);
             if ((c >= first) && (c <= last))
             { // Char present in this font?
                 GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(
-                    &gfxFont->glyph))[c - first]);
+                    &ctx.gfxFont->glyph))[c - first]);
                 uint8_t gw = pgm_read_byte(&glyph->width),
                         gh = pgm_read_byte(&glyph->height),
                         xa = pgm_read_byte(&glyph->xAdvance);
                 int8_t xo = pgm_read_byte(&glyph->xOffset),
                        yo = pgm_read_byte(&glyph->yOffset);
-                if (wrap && ((*x + (((int16_t)xo + gw) * textsize)) > _width))
+                if (ctx.wrap && ((*x + (((int16_t)xo + gw) * ctx.textsize_x)) > _width))
                 {
                     *x = 0; // Reset x to zero, advance y by one line
-                    *y += textsize * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+                    *y += ctx.textsize_y * (uint8_t)pgm_read_byte(&ctx.gfxFont->yAdvance);
                 }
-                int16_t ts = (int16_t)textsize,
-                        x1 = *x + xo * ts,
-                        y1 = *y + yo * ts,
-                        x2 = x1 + gw * ts - 1,
-                        y2 = y1 + gh * ts - 1;
+                int16_t tsx = (int16_t)ctx.textsize_x,
+                        tsy = (int16_t)ctx.textsize_y,
+                        x1 = *x + xo * tsx,
+                        y1 = *y + yo * tsy,
+                        x2 = x1 + gw * tsx - 1,
+                        y2 = y1 + gh * tsy - 1;
                 if (x1 < *minx)
                     *minx = x1;
                 if (y1 < *miny)
@@ -1503,7 +2247,7 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int
                     *maxx = x2;
                 if (y2 > *maxy)
                     *maxy = y2;
-                *x += xa * ts;
+                *x += xa * tsx;
             }
         }
     }
@@ -1512,19 +2256,19 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int
 
         if (c == '\n')
         {                       // Newline?
-            *x = 0;             // Reset x to zero,
-            *y += textsize * 8; // advance y one line
+            *x = 0;               // Reset x to zero,
+            *y += ctx.textsize_y * 8; // advance y one line
             // min/max x/y unchaged -- that waits for next 'normal' character
         }
         else if (c != '\r')
         { // Normal char; ignore carriage returns
-            if (wrap && ((*x + textsize * 6) > _width))
-            {                       // Off right?
-                *x = 0;             // Reset x to zero,
-                *y += textsize * 8; // advance y one line
+            if (ctx.wrap && ((*x + ctx.textsize_x * 6) > _width))
+            {                         // Off right?
+                *x = 0;               // Reset x to zero,
+                *y += ctx.textsize_y * 8; // advance y one line
             }
-            int x2 = *x + textsize * 6 - 1, // Lower-right pixel of char
-                y2 = *y + textsize * 8 - 1;
+            int x2 = *x + ctx.textsize_x * 6 - 1, // Lower-right pixel of char
+                y2 = *y + ctx.textsize_y * 8 - 1;
             if (x2 > *maxx)
                 *maxx = x2; // Track max x, y
             if (y2 > *maxy)
@@ -1533,7 +2277,58 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int
                 *minx = *x; // Track min x, y
             if (*y < *miny)
                 *miny = *y;
-            *x += textsize * 6; // Advance x one char
+            *x += ctx.textsize_x * 6; // Advance x one char
+        }
+    }
+}
+
+/**************************************************************************/
+/*!
+    @brief    Streamed font version of charBounds(), taking a (possibly
+       multi-byte) character code already decoded from the string.
+    @param    ctx   Drawing context supplying font, size and wrap setting
+    @param    c     The character code in question
+    @param    x     Pointer to x location of character
+    @param    y     Pointer to y location of character
+    @param    minx  Minimum clipping value for X
+    @param    miny  Minimum clipping value for Y
+    @param    maxx  Maximum clipping value for X
+    @param    maxy  Maximum clipping value for Y
+*/
+/**************************************************************************/
+void Adafruit_GFX::streamCharBounds(const GFXcontext &ctx, uint16_t c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy)
+{
+    if (c == '\n')
+    {           // Newline?
+        *x = 0; // Reset x to zero, advance y by one line
+        *y += ctx.textsize_y * ctx.streamFont->yAdvance();
+    }
+    else if (c != '\r')
+    { // Not a carriage return; is normal char
+        const uint8_t *bitmap;
+        const GFXglyph *glyph = ctx.streamFont->getGlyph(c, &bitmap);
+        if (glyph)
+        { // Char present in this font?
+            if (ctx.wrap && ((*x + (((int16_t)glyph->xOffset + glyph->width) * ctx.textsize_x)) > _width))
+            {
+                *x = 0; // Reset x to zero, advance y by one line
+                *y += ctx.textsize_y * ctx.streamFont->yAdvance();
+            }
+            int16_t tsx = (int16_t)ctx.textsize_x,
+                    tsy = (int16_t)ctx.textsize_y,
+                    x1 = *x + glyph->xOffset * tsx,
+                    y1 = *y + glyph->yOffset * tsy,
+                    x2 = x1 + glyph->width * tsx - 1,
+                    y2 = y1 + glyph->height * tsy - 1;
+            if (x1 < *minx)
+                *minx = x1;
+            if (y1 < *miny)
+                *miny = y1;
+            if (x2 > *maxx)
+                *maxx = x2;
+            if (y2 > *maxy)
+                *maxy = y2;
+            *x += glyph->xAdvance * tsx;
         }
     }
 }
@@ -1551,6 +2346,24 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int
 */
 /**************************************************************************/
 void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h)
+{
+    getTextBounds(ctx, str, x, y, x1, y1, w, h);
+}
+
+/**************************************************************************/
+/*!
+    @brief    Helper to determine size of a string with the font/size of a drawing context. Pass string and a cursor position, returns UL corner and W,H.
+    @param    ctx     Drawing context supplying font, size and wrap setting
+    @param    str     The ascii string to measure
+    @param    x       The current cursor X
+    @param    y       The current cursor Y
+    @param    x1      The boundary X coordinate, set by function
+    @param    y1      The boundary Y coordinate, set by function
+    @param    w      The boundary width, set by function
+    @param    h      The boundary height, set by function
+*/
+/**************************************************************************/
+void Adafruit_GFX::getTextBounds(const GFXcontext &ctx, const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h)
 {
     uint8_t c; // Current character
 
@@ -1559,9 +2372,16 @@ void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y, int16_t
     *w = *h = 0;
 
     int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+    uint16_t code = 0;
+    uint8_t left = 0;
 
     while ((c = *str++))
-        charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+    {
+        if (!ctx.streamFont)
+            charBounds(ctx, c, &x, &y, &minx, &miny, &maxx, &maxy);
+        else if (!ctx.streamFont->isUnicode() || GFXstreamFont::decodeUTF8(c, &code, &left))
+            streamCharBounds(ctx, ctx.streamFont->isUnicode() ? code : c, &x, &y, &minx, &miny, &maxx, &maxy);
+    }
 
     if (maxx >= minx)
     {
@@ -1626,6 +2446,190 @@ void Adafruit_GFX::invertDisplay(boolean i)
     // Do nothing, must be subclassed if supported by hardware
 }
 
+/**************************************************************************/
+/*!
+    @brief      Get the device's own drawing context, as used by print(),
+                setCursor(), setFont() etc. Copy it to start another
+                context with the same settings.
+    @returns    Reference to the device's drawing context
+*/
+/**************************************************************************/
+GFXcontext &Adafruit_GFX::context(void)
+{
+    return ctx;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Create a drawing context with the default settings (cursor at
+   0,0, white text with transparent background, size 1, wrap on, classic
+   font)
+*/
+/**************************************************************************/
+GFXcontext::GFXcontext(void)
+{
+    cursor_y = cursor_x = 0;
+    textsize_x = textsize_y = 1;
+    textcolor = textbgcolor = 0xFFFF;
+    wrap = true;
+    _cp437 = false;
+    gfxFont = NULL;
+    streamFont = NULL;
+    utf8_code = 0;
+    utf8_left = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Set text cursor location
+    @param  x    X coordinate in pixels
+    @param  y    Y coordinate in pixels
+*/
+/**************************************************************************/
+void GFXcontext::setCursor(int16_t x, int16_t y)
+{
+    cursor_x = x;
+    cursor_y = y;
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text 'magnification' size. Each increase in s makes 1 pixel that much bigger.
+    @param  s  Desired text size. 1 is default 6x8, 2 is 12x16, 3 is 18x24, etc
+*/
+/**************************************************************************/
+void GFXcontext::setTextSize(uint8_t s)
+{
+    setTextSize(s, s);
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text 'magnification' size. Each increase in s makes 1 pixel that much bigger.
+    @param  s_x  Desired text width magnification level in X-axis. 1 is default
+    @param  s_y  Desired text width magnification level in Y-axis. 1 is default
+*/
+/**************************************************************************/
+void GFXcontext::setTextSize(uint8_t s_x, uint8_t s_y)
+{
+    textsize_x = (s_x > 0) ? s_x : 1;
+    textsize_y = (s_y > 0) ? s_y : 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text font color with transparant background
+    @param   c   16-bit 5-6-5 Color to draw text with
+*/
+/**************************************************************************/
+void GFXcontext::setTextColor(uint16_t c)
+{
+    // For 'transparent' background, we'll set the bg
+    // to the same as fg instead of using a flag
+    textcolor = textbgcolor = c;
+}
+
+/**************************************************************************/
+/*!
+    @brief   Set text font color with custom background color
+    @param   c   16-bit 5-6-5 Color to draw text with
+    @param   b   16-bit 5-6-5 Color to draw background/fill with
+*/
+/**************************************************************************/
+void GFXcontext::setTextColor(uint16_t c, uint16_t b)
+{
+    textcolor = c;
+    textbgcolor = b;
+}
+
+/**************************************************************************/
+/*!
+    @brief      Whether text that is too long should 'wrap' around to the next line.
+    @param  w Set true for wrapping, false for clipping
+*/
+/**************************************************************************/
+void GFXcontext::setTextWrap(boolean w)
+{
+    wrap = w;
+}
+
+/**************************************************************************/
+/*!
+    @brief Enable (or disable) Code Page 437-compatible charset, see
+    Adafruit_GFX::cp437().
+    @param  x  Whether to enable (True) or not (False)
+*/
+/**************************************************************************/
+void GFXcontext::cp437(boolean x)
+{
+    _cp437 = x;
+}
+
+/**************************************************************************/
+/*!
+    @brief Set the font to display when print()ing, either custom or default
+    @param  f  The GFXfont object, if NULL use built in 6x8 font
+*/
+/**************************************************************************/
+void GFXcontext::setFont(const GFXfont *f)
+{
+    if (f)
+    { // Font struct pointer passed in?
+        if (!gfxFont && !streamFont)
+        { // And no current font struct?
+            // Switching from classic to new font behavior.
+            // Move cursor pos down 6 pixels so it's on baseline.
+            cursor_y += 6;
+        }
+    }
+    else if (gfxFont || streamFont)
+    { // NULL passed.  Current font struct defined?
+        // Switching from new to classic font behavior.
+        // Move cursor pos up 6 pixels so it's at top-left of char.
+        cursor_y -= 6;
+    }
+    gfxFont = (GFXfont *)f;
+    streamFont = NULL;
+}
+
+/**************************************************************************/
+/*!
+    @brief Set a streamed font to display when print()ing, see
+    Adafruit_GFX::setStreamFont(). A streamed font's glyph cache is not
+    thread-safe: contexts used concurrently need their own GFXstreamFont.
+    @param  f  The GFXstreamFont object, begin() already called. If NULL use
+    built in 6x8 font
+*/
+/**************************************************************************/
+void GFXcontext::setStreamFont(GFXstreamFont *f)
+{
+    if (f && !gfxFont && !streamFont)
+        cursor_y += 6; // Classic to baseline-relative font, as in setFont()
+    else if (!f && (gfxFont || streamFont))
+        cursor_y -= 6;
+    gfxFont = NULL;
+    streamFont = f;
+    utf8_left = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief      Free-running microsecond clock used for time budgets and
+                statistics (us_ticker on mbed, steady_clock elsewhere)
+    @returns    Microseconds, wrapping at 32 bits
+*/
+/**************************************************************************/
+uint32_t gfxMicros(void)
+{
+#if defined(__MBED__)
+    return us_ticker_read();
+#else
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
 /***************************************************************************/
 
 /**************************************************************************/
@@ -1790,6 +2794,218 @@ boolean Adafruit_GFX_Button::justReleased() { return (!currstate && laststate);
 // scanline pad).
 // NOT EXTENSIVELY TESTED YET.  MAY CONTAIN WORST BUGS KNOWN TO HUMANKIND.
 
+// Unrotated pixel access shared by the canvases' floodFill(); depth is 1,
+// 8 or 16 bits, colors as stored (so 0/1 for 1 bit).
+static inline uint16_t rawGet(const uint8_t *buffer, uint8_t depth, int16_t width, int16_t x, int16_t y)
+{
+    if (depth == 1)
+        return (buffer[(x / 8) + y * ((width + 7) / 8)] >> (7 - (x & 7))) & 1;
+    if (depth == 8)
+        return buffer[x + y * width];
+    return ((const uint16_t *)buffer)[x + y * width];
+}
+
+static inline void rawSet(uint8_t *buffer, uint8_t depth, int16_t width, int16_t x, int16_t y, uint16_t color)
+{
+    if (depth == 1)
+    {
+        uint8_t *ptr = &buffer[(x / 8) + y * ((width + 7) / 8)];
+        if (color)
+            *ptr |= 0x80 >> (x & 7);
+        else
+            *ptr &= ~(0x80 >> (x & 7));
+    }
+    else if (depth == 8)
+        buffer[x + y * width] = color;
+    else
+        ((uint16_t *)buffer)[x + y * width] = color;
+}
+
+static inline bool pushSpan(GFXfillSpan *stack, uint16_t capacity, uint16_t *n, int16_t height, int16_t y, int16_t x0, int16_t x1, int16_t dy)
+{
+    if ((y + dy < 0) || (y + dy >= height))
+        return true; // Nothing to scan
+    if (*n >= capacity)
+        return false;
+    GFXfillSpan &s = stack[(*n)++];
+    s.x0 = x0;
+    s.x1 = x1;
+    s.y = y;
+    s.dy = dy;
+    return true;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Scanline seed fill (Heckbert, Graphics Gems) of an unrotated
+             canvas buffer: each run of the old color is found and filled
+             in one sweep, and only runs still to be scanned in the rows
+             above and below are stacked.
+    @param   buffer    Canvas pixels
+    @param   depth     Bits per pixel: 1, 8 or 16
+    @param   width     Buffer width, in pixels
+    @param   height    Buffer height, in pixels
+    @param   x         Seed x coordinate, MUST be in the buffer
+    @param   y         Seed y coordinate, MUST be in the buffer
+    @param   color     New color, as stored
+    @param   stack     Span stack, or NULL for GFX_FLOOD_STACK on the stack
+    @param   capacity  Entries in stack
+    @returns False if the stack overflowed (the area may be partly filled)
+*/
+/**************************************************************************/
+static bool scanFill(uint8_t *buffer, uint8_t depth, int16_t width, int16_t height, int16_t x, int16_t y, uint16_t color, GFXfillSpan *stack, uint16_t capacity)
+{
+    uint16_t old = rawGet(buffer, depth, width, x, y);
+    if (old == color)
+        return true;
+
+    GFXfillSpan local[GFX_FLOOD_STACK];
+    if (!stack)
+    {
+        stack = local;
+        capacity = GFX_FLOOD_STACK;
+    }
+
+    uint16_t n = 0;
+    bool complete = pushSpan(stack, capacity, &n, height, y, x, x, 1);
+    complete &= pushSpan(stack, capacity, &n, height, y + 1, x, x, -1);
+    while (n)
+    {
+        GFXfillSpan s = stack[--n];
+        int16_t dy = s.dy, l;
+        y = s.y + dy;
+
+        // Fill left from the parent run's left end
+        for (x = s.x0; (x >= 0) && (rawGet(buffer, depth, width, x, y) == old); x--)
+            rawSet(buffer, depth, width, x, y, color);
+        bool run = (x < s.x0);
+        if (run)
+        {
+            l = x + 1;
+            if (l < s.x0) // Leaked left past the parent, look back too
+                complete &= pushSpan(stack, capacity, &n, height, y, l, s.x0 - 1, -dy);
+            x = s.x0 + 1;
+        }
+        else
+        {
+            for (x = s.x0 + 1; (x <= s.x1) && (rawGet(buffer, depth, width, x, y) != old); x++)
+                ;
+            l = x;
+        }
+
+        while (run || (x <= s.x1))
+        {
+            run = false;
+            for (; (x < width) && (rawGet(buffer, depth, width, x, y) == old); x++)
+                rawSet(buffer, depth, width, x, y, color);
+            complete &= pushSpan(stack, capacity, &n, height, y, l, x - 1, dy);
+            if (x > s.x1 + 1) // Leaked right past the parent
+                complete &= pushSpan(stack, capacity, &n, height, y, s.x1 + 1, x - 1, -dy);
+            for (x++; (x <= s.x1) && (rawGet(buffer, depth, width, x, y) != old); x++)
+                ;
+            l = x;
+        }
+    }
+    return complete;
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an image through an affine map straight into a canvas
+   buffer, the rotation folded into the map so it walks unrotated rows.
+    @param    buffer  Canvas buffer
+    @param    depth   Bits per pixel: 1, 8 or 16
+    @param    bitmap  w * h pixels
+    @param    mask    1 bit per pixel (see drawRGBBitmapTransformed()), or
+                      NULL
+    @param    w       Image width
+    @param    h       Image height
+    @param    m       Map from display to image positions
+    @param    area    Display area to draw in, MUST be onscreen
+*/
+/**************************************************************************/
+void Adafruit_GFX::transformRaw(uint8_t *buffer, uint8_t depth, const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area)
+{
+    GFXaffine r = m;
+    switch (rotation)
+    {
+    case 1: // x = ry, y = WIDTH - 1 - rx
+        r.a = -m.b;
+        r.b = m.a;
+        r.tx = m.tx + m.b * (WIDTH - 1);
+        r.c = -m.d;
+        r.d = m.c;
+        r.ty = m.ty + m.d * (WIDTH - 1);
+        break;
+    case 2: // x = WIDTH - 1 - rx, y = HEIGHT - 1 - ry
+        r.a = -m.a;
+        r.b = -m.b;
+        r.tx = m.tx + m.a * (WIDTH - 1) + m.b * (HEIGHT - 1);
+        r.c = -m.c;
+        r.d = -m.d;
+        r.ty = m.ty + m.c * (WIDTH - 1) + m.d * (HEIGHT - 1);
+        break;
+    case 3: // x = HEIGHT - 1 - ry, y = rx
+        r.a = m.b;
+        r.b = -m.a;
+        r.tx = m.tx + m.a * (HEIGHT - 1);
+        r.c = m.d;
+        r.d = -m.c;
+        r.ty = m.ty + m.c * (HEIGHT - 1);
+        break;
+    }
+
+    int16_t x = area.x, y = area.y, aw = area.w, ah = area.h, maskStride = (w + 7) / 8;
+    rotateRect(&x, &y, &aw, &ah);
+    for (int16_t ry = y; ry < y + ah; ry++)
+    {
+        int16_t x0 = x, x1 = x + aw - 1;
+        int32_t u, v;
+        if (!affineSpan(r, w, h, ry, &x0, &x1, &u, &v))
+            continue;
+        for (int16_t rx = x0; rx <= x1; rx++, u += r.a, v += r.c)
+        {
+            int16_t su = u >> 16, sv = v >> 16;
+            if (!mask || (pgm_read_byte(&mask[sv * maskStride + su / 8]) & (0x80 >> (su & 7))))
+                rawSet(buffer, depth, WIDTH, rx, ry, pgm_read_word(&bitmap[sv * w + su]));
+        }
+    }
+}
+
+// Move the pixels of an unrotated, clipped rectangle of an 8- or 16-bit
+// canvas by a displacement given at the canvas rotation, a row at a time.
+static void rawScroll(uint8_t *buffer, uint8_t bytes, int16_t width, uint8_t rotation, int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy)
+{
+    int16_t t;
+    switch (rotation)
+    {
+    case 1:
+        t = dx;
+        dx = -dy;
+        dy = t;
+        break;
+    case 2:
+        dx = -dx;
+        dy = -dy;
+        break;
+    case 3:
+        t = dx;
+        dx = dy;
+        dy = -t;
+        break;
+    }
+    int16_t n = w - abs(dx), rows = h - abs(dy);
+    if ((n <= 0) || (rows <= 0))
+        return; // All uncovered
+    int16_t to = x + ((dx > 0) ? dx : 0), from = x + ((dx < 0) ? -dx : 0);
+    for (int16_t j = 0; j < rows; j++)
+    {
+        int16_t row = (dy > 0) ? (y + h - 1 - j) : (y + j); // Destination, away from the source
+        uint8_t *dst = &buffer[(row * width) * bytes];
+        memmove(&dst[to * bytes], &buffer[((row - dy) * width + from) * bytes], n * bytes);
+    }
+}
+
 /**************************************************************************/
 /*!
    @brief    Instatiate a GFX 1-bit canvas context for graphics
@@ -1885,6 +3101,204 @@ void GFXcanvas1::fillScreen(uint16_t color)
     }
 }
 
+/**************************************************************************/
+/*!
+   @brief    Fill many rectangles, clipping and setting whole bytes at a time
+    @param    rects   Rectangles, drawn in order (zero or negative sizes are skipped)
+    @param    colors  Color of each rectangle (0 clears, others set)
+    @param    n       Number of rectangles
+*/
+/**************************************************************************/
+void GFXcanvas1::fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n)
+{
+    if (!buffer)
+        return;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = rects[i].x, y = rects[i].y, w = rects[i].w, h = rects[i].h;
+        if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+            fillRaw(x, y, w, h, colors[i]);
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Draw many horizontal spans, clipping and setting whole bytes at a time
+    @param    spans  Spans, drawn in order (zero or negative widths are skipped)
+    @param    n      Number of spans
+*/
+/**************************************************************************/
+void GFXcanvas1::drawSpans(const GFXspan *spans, uint16_t n)
+{
+    if (!buffer)
+        return;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = spans[i].x, y = spans[i].y, w = spans[i].w, h = 1;
+        if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+            fillRaw(x, y, w, h, spans[i].color);
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill an unrotated, clipped rectangle of the framebuffer
+    @param    x      Left edge (rotation 0)
+    @param    y      Top edge (rotation 0)
+    @param    w      Width, MUST be positive and on screen
+    @param    h      Height, MUST be positive and on screen
+    @param    color  0 clears, others set
+*/
+/**************************************************************************/
+void GFXcanvas1::fillRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    uint16_t stride = (WIDTH + 7) / 8;
+    int16_t b0 = x / 8, b1 = (x + w - 1) / 8;
+    uint8_t m0 = 0xFF >> (x & 7), m1 = 0xFF << (7 - ((x + w - 1) & 7));
+    if (b0 == b1)
+        m0 = m1 = m0 & m1;
+    for (uint8_t *row = &buffer[y * stride]; h--; row += stride)
+    {
+        if (color)
+        {
+            row[b0] |= m0;
+            if (b1 > b0)
+            {
+                memset(&row[b0 + 1], 0xFF, b1 - b0 - 1);
+                row[b1] |= m1;
+            }
+        }
+        else
+        {
+            row[b0] &= ~m0;
+            if (b1 > b0)
+            {
+                memset(&row[b0 + 1], 0x00, b1 - b0 - 1);
+                row[b1] &= ~m1;
+            }
+        }
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill a rectangle with a transparent 8x8 stipple: pattern bits
+             set are drawn, others left alone. The pattern is anchored at
+             the screen origin, so neighbouring fills line up.
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    Color (0 clears, others set)
+*/
+/**************************************************************************/
+void GFXcanvas1::fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color)
+{
+    fillPattern(x, y, w, h, pattern, color, 0, false);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill a rectangle with an opaque 8x8 pattern, anchored at the
+             screen origin
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    Color (0 clears, others set) for bits set
+    @param    bg       Color (0 clears, others set) for bits clear
+*/
+/**************************************************************************/
+void GFXcanvas1::fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg)
+{
+    fillPattern(x, y, w, h, pattern, color, bg, true);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Flood fill: replace the area of one color that contains a
+             point (joined through its 4 neighbors) with another color.
+             Uses a stack of pending spans, not recursion; a thin, winding
+             area needs more entries than a convex one.
+    @param    x         Seed x coordinate
+    @param    y         Seed y coordinate
+    @param    color     Color (0 clears, others set) to fill with
+    @param    stack     Span stack, or NULL for GFX_FLOOD_STACK entries on
+                        the C stack
+    @param    capacity  Entries in stack
+    @returns  False if the stack overflowed, leaving the area partly
+              filled (fill again from a pixel left to finish)
+*/
+/**************************************************************************/
+bool GFXcanvas1::floodFill(int16_t x, int16_t y, uint16_t color, GFXfillSpan *stack, uint16_t capacity)
+{
+    int16_t w = 1, h = 1;
+    if (!buffer || !clipRect(&x, &y, &w, &h))
+        return true;
+    rotateRect(&x, &y, &w, &h);
+    return scanFill((uint8_t *)buffer, 1, WIDTH, HEIGHT, x, y, color ? 1 : 0, stack, capacity);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an image through an affine map, within an already-clipped
+   area, straight into the framebuffer
+    @param    bitmap  w * h pixels
+    @param    mask    1 bit per pixel (see drawRGBBitmapTransformed()), or
+                      NULL
+    @param    w       Image width
+    @param    h       Image height
+    @param    m       Map from display to image positions
+    @param    area    Display area to draw in, MUST be onscreen
+*/
+/**************************************************************************/
+void GFXcanvas1::drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area)
+{
+    if (buffer)
+        transformRaw(buffer, 1, bitmap, mask, w, h, m, area);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Clip, rotate and fill a rectangle with a pattern
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    Color for bits set
+    @param    bg       Color for bits clear, if opaque
+    @param    opaque   If false, pixels of bits clear are left alone
+*/
+/**************************************************************************/
+void GFXcanvas1::fillPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg, bool opaque)
+{
+    uint8_t raw[8];
+    if (!buffer || !clipRect(&x, &y, &w, &h) || !rotateRect(&x, &y, &w, &h))
+        return;
+    rotatePattern(pattern, raw);
+    uint16_t stride = (WIDTH + 7) / 8;
+    int16_t b0 = x / 8, b1 = (x + w - 1) / 8;
+    uint8_t m0 = 0xFF >> (x & 7), m1 = 0xFF << (7 - ((x + w - 1) & 7));
+    for (int16_t j = y; j < y + h; j++)
+    { // Pattern columns line up with bytes: whole bytes per row
+        uint8_t bits = raw[j & 7], *row = &buffer[j * stride];
+        uint8_t set = opaque ? ((color ? bits : 0) | (bg ? ~bits : 0)) : (color ? 0xFF : 0);
+        uint8_t mask = opaque ? 0xFF : bits;
+        for (int16_t b = b0; b <= b1; b++)
+        {
+            uint8_t m = mask;
+            if (b == b0)
+                m &= m0;
+            if (b == b1)
+                m &= m1;
+            row[b] = (row[b] & ~m) | (set & m);
+        }
+    }
+}
+
 /**************************************************************************/
 /*!
    @brief    Instatiate a GFX 8-bit canvas context for graphics
@@ -2012,6 +3426,202 @@ void GFXcanvas8::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
     memset(buffer + y * WIDTH + x, color, w);
 }
 
+/**************************************************************************/
+/*!
+   @brief    Fill many rectangles, clipping and filling a row at a time
+    @param    rects   Rectangles, drawn in order (zero or negative sizes are skipped)
+    @param    colors  8-bit color of each rectangle
+    @param    n       Number of rectangles
+*/
+/**************************************************************************/
+void GFXcanvas8::fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n)
+{
+    if (!buffer)
+        return;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = rects[i].x, y = rects[i].y, w = rects[i].w, h = rects[i].h;
+        if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+            fillRaw(x, y, w, h, colors[i]);
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Draw many horizontal spans, clipping and filling a row at a time
+    @param    spans  Spans, drawn in order (zero or negative widths are skipped)
+    @param    n      Number of spans
+*/
+/**************************************************************************/
+void GFXcanvas8::drawSpans(const GFXspan *spans, uint16_t n)
+{
+    if (!buffer)
+        return;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = spans[i].x, y = spans[i].y, w = spans[i].w, h = 1;
+        if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+            fillRaw(x, y, w, h, spans[i].color);
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill an unrotated, clipped rectangle of the framebuffer
+    @param    x      Left edge (rotation 0)
+    @param    y      Top edge (rotation 0)
+    @param    w      Width, MUST be positive and on screen
+    @param    h      Height, MUST be positive and on screen
+    @param    color  8-bit color
+*/
+/**************************************************************************/
+void GFXcanvas8::fillRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    for (uint8_t *row = &buffer[y * WIDTH + x]; h--; row += WIDTH)
+        memset(row, color, w);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill a rectangle with a transparent 8x8 stipple: pattern bits
+             set are drawn, others left alone. The pattern is anchored at
+             the screen origin, so neighbouring fills line up.
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    8-bit color
+*/
+/**************************************************************************/
+void GFXcanvas8::fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color)
+{
+    fillPattern(x, y, w, h, pattern, color, 0, false);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill a rectangle with an opaque 8x8 pattern, anchored at the
+             screen origin
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    8-bit color for bits set
+    @param    bg       8-bit color for bits clear
+*/
+/**************************************************************************/
+void GFXcanvas8::fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg)
+{
+    fillPattern(x, y, w, h, pattern, color, bg, true);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Flood fill: replace the area of one color that contains a
+             point (joined through its 4 neighbors) with another color.
+             Uses a stack of pending spans, not recursion; a thin, winding
+             area needs more entries than a convex one.
+    @param    x         Seed x coordinate
+    @param    y         Seed y coordinate
+    @param    color     8-bit color to fill with
+    @param    stack     Span stack, or NULL for GFX_FLOOD_STACK entries on
+                        the C stack
+    @param    capacity  Entries in stack
+    @returns  False if the stack overflowed, leaving the area partly
+              filled (fill again from a pixel left to finish)
+*/
+/**************************************************************************/
+bool GFXcanvas8::floodFill(int16_t x, int16_t y, uint16_t color, GFXfillSpan *stack, uint16_t capacity)
+{
+    int16_t w = 1, h = 1;
+    if (!buffer || !clipRect(&x, &y, &w, &h))
+        return true;
+    rotateRect(&x, &y, &w, &h);
+    return scanFill((uint8_t *)buffer, 8, WIDTH, HEIGHT, x, y, color & 0xFF, stack, capacity);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an image through an affine map, within an already-clipped
+   area, straight into the framebuffer
+    @param    bitmap  w * h pixels
+    @param    mask    1 bit per pixel (see drawRGBBitmapTransformed()), or
+                      NULL
+    @param    w       Image width
+    @param    h       Image height
+    @param    m       Map from display to image positions
+    @param    area    Display area to draw in, MUST be onscreen
+*/
+/**************************************************************************/
+void GFXcanvas8::drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area)
+{
+    if (buffer)
+        transformRaw(buffer, 8, bitmap, mask, w, h, m, area);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Move the pixels of a rectangle by (dx, dy) within it, a row at a
+   time; the area uncovered keeps its old pixels, for the caller to redraw
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    w   Width in pixels
+    @param    h   Height in pixels
+    @param    dx  Distance to move right (negative: left)
+    @param    dy  Distance to move down (negative: up)
+    @returns  true (false if there is no buffer)
+*/
+/**************************************************************************/
+bool GFXcanvas8::scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy)
+{
+    if (!buffer)
+        return false;
+    if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+        rawScroll(buffer, 1, WIDTH, rotation, x, y, w, h, dx, dy);
+    return true;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Clip, rotate and fill a rectangle with a pattern
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    Color for bits set
+    @param    bg       Color for bits clear, if opaque
+    @param    opaque   If false, pixels of bits clear are left alone
+*/
+/**************************************************************************/
+void GFXcanvas8::fillPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg, bool opaque)
+{
+    uint8_t raw[8];
+    if (!buffer || !clipRect(&x, &y, &w, &h) || !rotateRect(&x, &y, &w, &h))
+        return;
+    rotatePattern(pattern, raw);
+    for (int16_t j = y; j < y + h; j++)
+    {
+        uint8_t bits = raw[j & 7], *row = &buffer[j * WIDTH];
+        if (opaque)
+        { // One row of the pattern, then copied along
+            uint8_t colors[8];
+            for (uint8_t i = 0; i < 8; i++)
+                colors[i] = (bits & (0x80 >> i)) ? color : bg;
+            for (int16_t i = x; i < x + w; i++)
+                row[i] = colors[i & 7];
+        }
+        else
+        {
+            for (int16_t i = x; i < x + w; i++)
+                if (bits & (0x80 >> (i & 7)))
+                    row[i] = color;
+        }
+    }
+}
+
 /**************************************************************************/
 /*!
    @brief    Instatiate a GFX 16-bit canvas context for graphics
@@ -2024,6 +3634,23 @@ GFXcanvas16::GFXcanvas16(uint16_t w, uint16_t h) : Adafruit_GFX(w, h)
     uint32_t bytes = w * h * 2;
     if ((buffer = (uint16_t *)malloc(bytes)))
         memset(buffer, 0, bytes);
+    owned = true;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Instatiate a GFX 16-bit canvas drawing into memory supplied by
+             the caller (e.g. a memory-mapped file, see GFXmappedCanvas16),
+             which is neither cleared nor freed by the canvas
+   @param    w   Display width, in pixels
+   @param    h   Display height, in pixels
+   @param    buf w * h pixels of memory, or NULL (canvas draws nothing)
+*/
+/**************************************************************************/
+GFXcanvas16::GFXcanvas16(uint16_t w, uint16_t h, uint16_t *buf) : Adafruit_GFX(w, h)
+{
+    buffer = buf;
+    owned = false;
 }
 
 /**************************************************************************/
@@ -2033,7 +3660,7 @@ GFXcanvas16::GFXcanvas16(uint16_t w, uint16_t h) : Adafruit_GFX(w, h)
 /**************************************************************************/
 GFXcanvas16::~GFXcanvas16(void)
 {
-    if (buffer)
+    if (buffer && owned)
         free(buffer);
 }
 
@@ -2109,3 +3736,207 @@ void GFXcanvas16::fillScreen(uint16_t color)
         }
     }
 }
+
+/**************************************************************************/
+/*!
+   @brief    Fill many rectangles, clipping and filling a row at a time
+    @param    rects   Rectangles, drawn in order (zero or negative sizes are skipped)
+    @param    colors  16-bit 5-6-5 color of each rectangle
+    @param    n       Number of rectangles
+*/
+/**************************************************************************/
+void GFXcanvas16::fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n)
+{
+    if (!buffer)
+        return;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = rects[i].x, y = rects[i].y, w = rects[i].w, h = rects[i].h;
+        if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+            fillRaw(x, y, w, h, colors[i]);
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Draw many horizontal spans, clipping and filling a row at a time
+    @param    spans  Spans, drawn in order (zero or negative widths are skipped)
+    @param    n      Number of spans
+*/
+/**************************************************************************/
+void GFXcanvas16::drawSpans(const GFXspan *spans, uint16_t n)
+{
+    if (!buffer)
+        return;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = spans[i].x, y = spans[i].y, w = spans[i].w, h = 1;
+        if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+            fillRaw(x, y, w, h, spans[i].color);
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill an unrotated, clipped rectangle of the framebuffer
+    @param    x      Left edge (rotation 0)
+    @param    y      Top edge (rotation 0)
+    @param    w      Width, MUST be positive and on screen
+    @param    h      Height, MUST be positive and on screen
+    @param    color  16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void GFXcanvas16::fillRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    bool bytes = (color >> 8) == (color & 0xFF); // memset() will do
+    for (uint16_t *row = &buffer[y * WIDTH + x]; h--; row += WIDTH)
+    {
+        if (bytes)
+            memset(row, color & 0xFF, w * 2);
+        else
+            for (int16_t i = 0; i < w; i++)
+                row[i] = color;
+    }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill a rectangle with a transparent 8x8 stipple: pattern bits
+             set are drawn, others left alone. The pattern is anchored at
+             the screen origin, so neighbouring fills line up.
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    16-bit 5-6-5 color
+*/
+/**************************************************************************/
+void GFXcanvas16::fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color)
+{
+    fillPattern(x, y, w, h, pattern, color, 0, false);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Fill a rectangle with an opaque 8x8 pattern, anchored at the
+             screen origin
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    16-bit 5-6-5 color for bits set
+    @param    bg       16-bit 5-6-5 color for bits clear
+*/
+/**************************************************************************/
+void GFXcanvas16::fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg)
+{
+    fillPattern(x, y, w, h, pattern, color, bg, true);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Flood fill: replace the area of one color that contains a
+             point (joined through its 4 neighbors) with another color.
+             Uses a stack of pending spans, not recursion; a thin, winding
+             area needs more entries than a convex one.
+    @param    x         Seed x coordinate
+    @param    y         Seed y coordinate
+    @param    color     16-bit 5-6-5 color to fill with
+    @param    stack     Span stack, or NULL for GFX_FLOOD_STACK entries on
+                        the C stack
+    @param    capacity  Entries in stack
+    @returns  False if the stack overflowed, leaving the area partly
+              filled (fill again from a pixel left to finish)
+*/
+/**************************************************************************/
+bool GFXcanvas16::floodFill(int16_t x, int16_t y, uint16_t color, GFXfillSpan *stack, uint16_t capacity)
+{
+    int16_t w = 1, h = 1;
+    if (!buffer || !clipRect(&x, &y, &w, &h))
+        return true;
+    rotateRect(&x, &y, &w, &h);
+    return scanFill((uint8_t *)buffer, 16, WIDTH, HEIGHT, x, y, color, stack, capacity);
+}
+
+/**************************************************************************/
+/*!
+   @brief   Draw an image through an affine map, within an already-clipped
+   area, straight into the framebuffer
+    @param    bitmap  w * h pixels
+    @param    mask    1 bit per pixel (see drawRGBBitmapTransformed()), or
+                      NULL
+    @param    w       Image width
+    @param    h       Image height
+    @param    m       Map from display to image positions
+    @param    area    Display area to draw in, MUST be onscreen
+*/
+/**************************************************************************/
+void GFXcanvas16::drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area)
+{
+    if (buffer)
+        transformRaw((uint8_t *)buffer, 16, bitmap, mask, w, h, m, area);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Move the pixels of a rectangle by (dx, dy) within it, a row at a
+   time; the area uncovered keeps its old pixels, for the caller to redraw
+    @param    x   Top left corner x coordinate
+    @param    y   Top left corner y coordinate
+    @param    w   Width in pixels
+    @param    h   Height in pixels
+    @param    dx  Distance to move right (negative: left)
+    @param    dy  Distance to move down (negative: up)
+    @returns  true (false if there is no buffer)
+*/
+/**************************************************************************/
+bool GFXcanvas16::scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy)
+{
+    if (!buffer)
+        return false;
+    if (clipRect(&x, &y, &w, &h) && rotateRect(&x, &y, &w, &h))
+        rawScroll((uint8_t *)buffer, 2, WIDTH, rotation, x, y, w, h, dx, dy);
+    return true;
+}
+
+/**************************************************************************/
+/*!
+   @brief    Clip, rotate and fill a rectangle with a pattern
+    @param    x        Top left corner x coordinate
+    @param    y        Top left corner y coordinate
+    @param    w        Width in pixels
+    @param    h        Height in pixels
+    @param    pattern  8 rows, MSB = left pixel
+    @param    color    Color for bits set
+    @param    bg       Color for bits clear, if opaque
+    @param    opaque   If false, pixels of bits clear are left alone
+*/
+/**************************************************************************/
+void GFXcanvas16::fillPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg, bool opaque)
+{
+    uint8_t raw[8];
+    if (!buffer || !clipRect(&x, &y, &w, &h) || !rotateRect(&x, &y, &w, &h))
+        return;
+    rotatePattern(pattern, raw);
+    for (int16_t j = y; j < y + h; j++)
+    {
+        uint8_t bits = raw[j & 7];
+        uint16_t *row = &buffer[j * WIDTH];
+        if (opaque)
+        { // One row of the pattern, then copied along
+            uint16_t colors[8];
+            for (uint8_t i = 0; i < 8; i++)
+                colors[i] = (bits & (0x80 >> i)) ? color : bg;
+            for (int16_t i = x; i < x + w; i++)
+                row[i] = colors[i & 7];
+        }
+        else
+        {
+            for (int16_t i = x; i < x + w; i++)
+                if (bits & (0x80 >> (i & 7)))
+                    row[i] = color;
+        }
+    }
+}
@@ -4,6 +4,9 @@
 #include "Arduino.h"
 #include "gfxfont.h"
 
+class GFXstreamFont;
+class GFXimage;
+
 // Many (but maybe not all) non-AVR board installs define macros
 // for compatibility with existing PROGMEM-reading AVR code.
 // Do our own checks and defines here for good measure...
@@ -27,6 +30,85 @@
 #define pgm_read_pointer(addr) ((void *)pgm_read_word(addr))
 #endif
 
+uint32_t gfxMicros(void); // Free-running microsecond clock (wraps)
+
+/// Rectangle for fillRects(); zero or negative sizes draw nothing
+typedef struct
+{
+	int16_t x, y; ///< Top left corner
+	int16_t w, h; ///< Size
+} GFXrect;
+
+/// Horizontal run of one color for drawSpans(); w < 1 draws nothing
+typedef struct
+{
+	int16_t x, y;   ///< Left end
+	int16_t w;		///< Length
+	uint16_t color; ///< 16-bit 5-6-5 color
+} GFXspan;
+
+#ifndef GFX_FLOOD_STACK
+#define GFX_FLOOD_STACK 32 ///< Spans floodFill() keeps on the stack when not given a stack
+#endif
+
+/// Pending run of pixels for the canvases' floodFill() span stack
+typedef struct
+{
+	int16_t x0, x1; ///< Run of the parent row, inclusive
+	int16_t y;		///< Parent row
+	int16_t dy;		///< Direction to scan (+1 down, -1 up)
+} GFXfillSpan;
+
+/// Affine map for drawRGBBitmapTransformed(), 16.16 fixed point: destination pixel (x, y) takes the source pixel at the integer part of (u, v) = (a * x + b * y + tx, c * x + d * y + ty). Make one with gfxAffineRotate(), or fill it in directly for shears, flips etc.
+typedef struct
+{
+	int32_t a, b, tx; ///< Source column terms
+	int32_t c, d, ty; ///< Source row terms
+} GFXaffine;
+
+// Rotate (clockwise) and scale about a pivot point in the source image,
+// placed at (x, y) on the display:
+void gfxAffineRotate(GFXaffine *m, float degrees, float scale, float pivotX, float pivotY, int16_t x, int16_t y);
+
+/// Text drawing state: cursor, colors, size, wrap and font. Every Adafruit_GFX has its own (used by print(), setCursor() etc.); more can be created, or copied from a device's context(), and passed to the context-taking text functions so that threads or parallel renders share no text state. Contexts hold no pixels and may be used with any device; the device itself is not thread-safe, so threads drawing to the same one must lock around it.
+class GFXcontext
+{
+public:
+	GFXcontext(void);
+
+	void
+	setCursor(int16_t x, int16_t y),
+		setTextColor(uint16_t c),
+		setTextColor(uint16_t c, uint16_t bg),
+		setTextSize(uint8_t s),
+		setTextSize(uint8_t s_x, uint8_t s_y),
+		setTextWrap(boolean w),
+		cp437(boolean x = true),
+		setFont(const GFXfont *f = NULL),
+		setStreamFont(GFXstreamFont *f);
+
+	int16_t
+		cursor_x, ///< x location to start print()ing text
+		cursor_y; ///< y location to start print()ing text
+	uint16_t
+		textcolor,   ///< 16-bit background color for print()
+		textbgcolor; ///< 16-bit text color for print()
+	uint8_t
+		textsize_x, ///< Desired magnification in X-axis of text to print()
+		textsize_y; ///< Desired magnification in Y-axis of text to print()
+	boolean
+		wrap,   ///< If set, 'wrap' text at right edge of display
+		_cp437; ///< If set, use correct CP437 charset (default is off)
+	GFXfont
+		*gfxFont; ///< Pointer to special font
+	GFXstreamFont
+		*streamFont; ///< Pointer to streamed font (exclusive with gfxFont)
+	uint16_t
+		utf8_code; ///< Code point being decoded by write() (streamed fonts)
+	uint8_t
+		utf8_left; ///< UTF-8 continuation bytes still expected by write()
+};
+
 /// A generic graphics superclass that can handle all sorts of drawing. At a minimum you can subclass and provide drawPixel(). At a maximum you can do a ton of overriding to optimize. Used for any/all Adafruit displays!
 class Adafruit_GFX : public Stream
 {
@@ -67,6 +149,36 @@ public:
 		drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color),
 		drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 
+	// Many rectangles or spans in one call (bar charts, heatmaps, scan-
+	// converted shapes), MAY be overridden to skip per-call overhead:
+	virtual void fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n);
+	virtual void drawSpans(const GFXspan *spans, uint16_t n);
+
+	// Move the pixels of a rectangle within it (scrolling), where the device
+	// can: canvases do; displays with hardware scrolling MAY override.
+	virtual bool scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy);
+
+	// Text rendering MAY be overridden by devices that can push a whole
+	// character cell at once (see Adafruit_SPITFT).
+	virtual void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+	virtual void drawClassicChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+	virtual void drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint16_t color, uint8_t size_x, uint8_t size_y);
+	void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+	void drawChar(const GFXcontext &ctx, int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+
+	// A region of a larger RAM-resident 16-bit image, MAY be overridden:
+	virtual void drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h);
+
+	// Images streamed from external storage; devices MAY override the
+	// preclipped variant (see Adafruit_SPITFT).
+	void drawImage(int16_t x, int16_t y, GFXimage &image, int16_t sx = 0, int16_t sy = 0, int16_t w = -1, int16_t h = -1);
+	virtual void drawImagePreclipped(int16_t x, int16_t y, GFXimage &image, int16_t sx, int16_t sy, int16_t w, int16_t h);
+
+	// RAM-resident 16-bit images rotated, scaled etc. by an affine map;
+	// devices MAY override the preclipped variant (see Adafruit_SPITFT).
+	void drawRGBBitmapTransformed(const uint16_t *bitmap, int16_t w, int16_t h, const GFXaffine &m, const uint8_t *mask = NULL, const GFXrect *clip = NULL);
+	virtual void drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area);
+
 	// These exist only with Adafruit_GFX (no subclass overrides)
 	void
 	drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color),
@@ -90,21 +202,27 @@ public:
 		drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h),
 		drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], const uint8_t mask[], int16_t w, int16_t h),
 		drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, uint8_t *mask, int16_t w, int16_t h),
-		drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size),
 		setCursor(int16_t x, int16_t y),
 		setTextColor(uint16_t c),
 		setTextColor(uint16_t c, uint16_t bg),
 		setTextSize(uint8_t s),
+		setTextSize(uint8_t s_x, uint8_t s_y),
 		setTextWrap(boolean w),
 		cp437(boolean x = true),
 		setFont(const GFXfont *f = NULL),
+		setStreamFont(GFXstreamFont *f),
 		getTextBounds(const char *string, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h),
-		getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+		getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h),
+		getTextBounds(const GFXcontext &ctx, const char *string, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
 
 	virtual size_t write(uint8_t);
+	size_t write(GFXcontext &ctx, uint8_t c);
 	int _putc(int value);
 	int _getc();
 	void print(char *str);
+	void print(GFXcontext &ctx, const char *str);
+
+	GFXcontext &context(void);
 
 	int16_t height(void) const;
 	int16_t width(void) const;
@@ -117,26 +235,26 @@ public:
 
 protected:
 	void
-	charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
+	charBounds(const GFXcontext &ctx, char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy),
+		streamCharBounds(const GFXcontext &ctx, uint16_t c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
+	bool charClip(int16_t px, int16_t py, int16_t w, int16_t h, uint8_t size_x, uint8_t size_y, int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1);
+	uint8_t classicFontColumn(unsigned char c, uint8_t col) const;
+	bool rotateRect(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const;
+	bool clipRect(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const;
+	void rotatePattern(const uint8_t pattern[8], uint8_t raw[8]) const;
+	bool affineBounds(const GFXaffine &m, int16_t w, int16_t h, GFXrect *area) const;
+	bool affineSpan(const GFXaffine &m, int16_t w, int16_t h, int16_t y, int16_t *x0, int16_t *x1, int32_t *u, int32_t *v) const;
+	void transformRaw(uint8_t *buffer, uint8_t depth, const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area);
 	const int16_t
 		WIDTH,  ///< This is the 'raw' display width - never changes
 		HEIGHT; ///< This is the 'raw' display height - never changes
 	int16_t
-		_width,   ///< Display width as modified by current rotation
-		_height,  ///< Display height as modified by current rotation
-		cursor_x, ///< x location to start print()ing text
-		cursor_y; ///< y location to start print()ing text
-	uint16_t
-		textcolor,   ///< 16-bit background color for print()
-		textbgcolor; ///< 16-bit text color for print()
+		_width,  ///< Display width as modified by current rotation
+		_height; ///< Display height as modified by current rotation
 	uint8_t
-		textsize, ///< Desired magnification of text to print()
 		rotation; ///< Display rotation (0 thru 3)
-	boolean
-		wrap,   ///< If set, 'wrap' text at right edge of display
-		_cp437; ///< If set, use correct CP437 charset (default is off)
-	GFXfont
-		*gfxFont; ///< Pointer to special font
+	GFXcontext
+		ctx; ///< Text drawing state used by print(), setCursor() etc.
 };
 
 /// A simple drawn button UI element
@@ -175,10 +293,19 @@ public:
 	GFXcanvas1(uint16_t w, uint16_t h);
 	~GFXcanvas1(void);
 	void drawPixel(int16_t x, int16_t y, uint16_t color),
-		fillScreen(uint16_t color);
+		fillScreen(uint16_t color),
+		fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n),
+		drawSpans(const GFXspan *spans, uint16_t n),
+		drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area),
+		fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color),
+		fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg);
+	bool floodFill(int16_t x, int16_t y, uint16_t color, GFXfillSpan *stack = NULL, uint16_t capacity = 0);
 	uint8_t *getBuffer(void);
 
 private:
+	void fillRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg, bool opaque);
+
 	uint8_t *buffer;
 };
 
@@ -190,11 +317,21 @@ public:
 	~GFXcanvas8(void);
 	void drawPixel(int16_t x, int16_t y, uint16_t color),
 		fillScreen(uint16_t color),
-		writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+		writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color),
+		fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n),
+		drawSpans(const GFXspan *spans, uint16_t n),
+		drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area),
+		fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color),
+		fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg);
+	bool scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy);
+	bool floodFill(int16_t x, int16_t y, uint16_t color, GFXfillSpan *stack = NULL, uint16_t capacity = 0);
 
 	uint8_t *getBuffer(void);
 
 private:
+	void fillRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg, bool opaque);
+
 	uint8_t *buffer;
 };
 
@@ -203,13 +340,25 @@ class GFXcanvas16 : public Adafruit_GFX
 {
 public:
 	GFXcanvas16(uint16_t w, uint16_t h);
+	GFXcanvas16(uint16_t w, uint16_t h, uint16_t *buf);
 	~GFXcanvas16(void);
 	void drawPixel(int16_t x, int16_t y, uint16_t color),
-		fillScreen(uint16_t color);
+		fillScreen(uint16_t color),
+		fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n),
+		drawSpans(const GFXspan *spans, uint16_t n),
+		drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area),
+		fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color),
+		fillRectPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg);
+	bool scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy);
+	bool floodFill(int16_t x, int16_t y, uint16_t color, GFXfillSpan *stack = NULL, uint16_t capacity = 0);
 	uint16_t *getBuffer(void);
 
 private:
+	void fillRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t pattern[8], uint16_t color, uint16_t bg, bool opaque);
+
 	uint16_t *buffer;
+	bool owned; ///< If set, buffer was allocated by (and is freed with) the canvas
 };
 
 #endif // _ADAFRUIT_GFX_H
@@ -32,17 +32,19 @@
  */
 
 #include "Adafruit_SPITFT.h"
+#include "GFXimage.h"
 
 #if defined(USE_SPI_DMA)
 // TODO: Implement DMA
 #endif // end USE_SPI_DMA
 
-// Possible values for Adafruit_SPITFT.connection:
-#define TFT_HARD_SPI 0 ///< Display interface = hardware SPI
-#define TFT_SOFT_SPI 1 ///< Display interface = software SPI
-// #define TFT_PARALLEL 2 ///< Display interface = 8- or 16-bit parallel
+// Steps of the non-blocking initialization sequence (initStep()):
+#define TFT_INIT_IDLE 0       ///< Nothing in progress
+#define TFT_INIT_RESET_HIGH 1 ///< Next: drive reset high (idle level)
+#define TFT_INIT_RESET_LOW 2  ///< Next: start reset pulse
+#define TFT_INIT_RESET_END 3  ///< Next: end reset pulse, then recover
+#define TFT_INIT_COMMANDS 4   ///< Next: send init command table
 
-uint8_t *spi_buffer;
 const int SPI_BUFFER_SIZE = 1024;
 
 // CONSTRUCTORS ------------------------------------------------------------
@@ -65,11 +67,8 @@ const int SPI_BUFFER_SIZE = 1024;
              this library's initSPI() function to initialize pins.
 */
 Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, PinName cs, PinName dc, PinName mosi, PinName sck, PinName rst, PinName miso)
-    : Adafruit_GFX(w, h), connection(TFT_SOFT_SPI), _w(w), _h(h), _rst(rst), _cs(cs), _dc(dc)
+    : Adafruit_GFX(w, h), _bus(new GFXsoftSpiBus(cs, dc, mosi, sck, miso)), _ownBus(true), _rst(rst), _w(w), _h(h)
 {
-    swspi._sck = sck;
-    swspi._mosi = mosi;
-    swspi._miso = miso;
 }
 
 /*!
@@ -87,9 +86,8 @@ Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, PinName cs, PinName dc,
              this library's initSPI() function to initialize pins.
 */
 Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, PinName cs, PinName dc, PinName rst)
-    : Adafruit_GFX(w, h), connection(TFT_HARD_SPI), _w(w), _h(h), _rst(rst), _cs(cs), _dc(dc)
+    : Adafruit_GFX(w, h), _bus(new GFXspiBus(*new SPI(SPI_MOSI, SPI_MISO, SPI_SCK, SPI_CS), cs, dc, 8, 0, DEFAULT_SPI_FREQ, true)), _ownBus(true), _rst(rst), _w(w), _h(h)
 {
-    hwspi._spi = new SPI(SPI_MOSI, SPI_MISO, SPI_SCK, SPI_CS);
 }
 
 /*!
@@ -111,12 +109,26 @@ Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, PinName cs, PinName dc,
              this library's initSPI() function to initialize pins.
 */
 Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, SPI &spi, PinName cs, PinName dc, PinName rst, int bits, int mode, uint32_t freq)
-    : Adafruit_GFX(w, h), connection(TFT_HARD_SPI), _w(w), _h(h), _rst(rst), _cs(cs), _dc(dc), _freq(freq)
+    : Adafruit_GFX(w, h), _bus(new GFXspiBus(spi, cs, dc, bits, mode, freq)), _ownBus(true), _rst(rst), _w(w), _h(h), _freq(freq)
+{
+}
+
+/*!
+    @brief   Adafruit_SPITFT constructor for a display on any bus.
+    @param   w    Display width in pixels at default rotation setting (0).
+    @param   h    Display height in pixels at default rotation setting (0).
+    @param   bus  Display bus (GFXspiBus, GFXsoftSpiBus, or an application's
+                  own GFXbus implementation). MUST outlive the display.
+    @param   rst  Pin for display reset (optional, display reset can be
+                  tied to MCU reset, default of NC means unused).
+    @return  Adafruit_SPITFT object.
+    @note    The bus is not initialized; application typically will need to
+             call subclass' begin() function, which in turn calls this
+             library's initSPI() function, which calls the bus' begin().
+*/
+Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, GFXbus &bus, PinName rst)
+    : Adafruit_GFX(w, h), _bus(&bus), _ownBus(false), _rst(rst), _w(w), _h(h)
 {
-    hwspi._spi = &spi;
-    hwspi._bits = bits;
-    hwspi._mode = mode;
-    hwspi._freq = freq;
 }
 
 /*!
@@ -154,7 +166,7 @@ Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, SPI &spi, PinName cs, P
 /*
 // TODO: Implement Parallel
 Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, tftBusWidth busWidth, PinName d0, PinName wr, PinName dc, PinName cs, PinName rst, PinName rd)
-    : Adafruit_GFX(w, h), connection(TFT_PARALLEL), _w(w), _h(h), _rst(rst), _cs(cs), _dc(dc)
+    : Adafruit_GFX(w, h), _w(w), _h(h), _rst(rst)
 {
     tft8._d0 = d0;
     tft8._wr = wr;
@@ -163,6 +175,19 @@ Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, tftBusWidth busWidth, P
 }
 */
 
+/*!
+    @brief  Adafruit_SPITFT destructor. Frees the staging buffer, and the
+            bus (and any SPI peripheral it was given) if a legacy
+            (pin-based) constructor created it.
+*/
+Adafruit_SPITFT::~Adafruit_SPITFT(void)
+{
+    if (_ownBus)
+        delete _bus;
+    if (spi_buffer)
+        free(spi_buffer);
+}
+
 // end constructors -------
 
 // CLASS MEMBER FUNCTIONS --------------------------------------------------
@@ -170,8 +195,11 @@ Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, tftBusWidth busWidth, P
 // begin() and setAddrWindow() MUST be declared by any subclass.
 
 /*!
-    @brief  Configure microcontroller pins for TFT interfacing. Typically
-            called by a subclass' begin() function.
+    @brief  Configure microcontroller pins for TFT interfacing and reset the
+            display. Typically called by a subclass' begin() function.
+            Blocks for the reset sequence (400 ms by default, see
+            setResetTiming()); initSPIAsync() is the non-blocking
+            equivalent.
     @note   Another anachronistically-named function; this is called even
             when the display connection is parallel (not SPI). Also, this
             could probably be made private...quite a few class functions
@@ -179,72 +207,125 @@ Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, tftBusWidth busWidth, P
 */
 void Adafruit_SPITFT::initSPI(void)
 {
-    // Init basic control pins common to all connection types
-    if (_cs >= 0)
-    {
-        pinMode(_cs, OUTPUT);
-        digitalWrite(_cs, HIGH); // Deselect
-    }
-    pinMode(_dc, OUTPUT);
-    digitalWrite(_dc, HIGH); // Data mode
+    initSPIAsync();
+    for (uint32_t us; (us = initStep());)
+        wait_us(us);
+}
 
-    if (connection == TFT_HARD_SPI)
-    {
-        /*
-        */
-        // Setup spi buffer
-        if ((spi_buffer = (uint8_t *)malloc(SPI_BUFFER_SIZE)))
-            memset(spi_buffer, 0, SPI_BUFFER_SIZE);
-        // Setup Hardware SPI
-        hwspi._spi->format(hwspi._bits, hwspi._mode);
-        hwspi._spi->frequency(hwspi._freq);
-        //hwspi._spi->begin();
-    }
-    else if (connection == TFT_SOFT_SPI)
-    {
-        pinMode(swspi._mosi, OUTPUT);
-        digitalWrite(swspi._mosi, LOW);
-        pinMode(swspi._sck, OUTPUT);
-        digitalWrite(swspi._sck, LOW);
-        if (swspi._miso >= 0)
-        {
-            pinMode(swspi._miso, INPUT);
-        }
-    }
-    /*
-    // TODO: Implement Parallel
-    else
-    {   // TFT_PARALLEL
-        // Initialize data pins.  We were only passed d0, so scan
-        // the pin description list looking for the other pins.
-        // They'll be on the same PORT, and within the next 7 (or 15) bits
-        // (because we need to write to a contiguous PORT byte or word).
-
-        pinMode(tft8._wr, OUTPUT);
-        digitalWrite(tft8._wr, HIGH);
-        if (tft8._rd >= 0)
-        {
-            pinMode(tft8._rd, OUTPUT);
-            digitalWrite(tft8._rd, HIGH);
-        }
-    }
-    */
+/*!
+    @brief  Configure microcontroller pins for TFT interfacing, then start
+            (but don't wait for) the display reset and, optionally, the
+            display's initialization commands. Nothing blocks: the sequence
+            is carried out by repeated initStep() calls, so the rest of
+            system startup can proceed meanwhile, e.g.:
+
+                tft.initSPIAsync(initcmd);
+                while (uint32_t us = tft.initStep())
+                    queue.dispatch(us / 1000); // or other startup work
+
+    @param  initCommands  Optional init command table (PROGMEM-resident),
+                          sent after reset. Each entry is a command byte,
+                          an argument count (OR'd with TFT_INIT_DELAY if a
+                          delay byte follows the arguments), the arguments,
+                          and the delay in ms if flagged (255 = 500 ms). A
+                          command byte of 0 ends the table.
+*/
+void Adafruit_SPITFT::initSPIAsync(const uint8_t *initCommands)
+{
+    // Bus pins and peripheral (display deselected, data mode)
+    _bus->begin();
+
+    // Setup spi buffer (also used to stage pixel data for any connection),
+    // once per display however often begin() is called
+    if (!spi_buffer && (spi_buffer = (uint8_t *)malloc(SPI_BUFFER_SIZE)))
+        memset(spi_buffer, 0, SPI_BUFFER_SIZE);
+
+#if defined(USE_SPI_DMA)
+    // TODO: Implement DMA
+#endif // end USE_SPI_DMA
+
+    _initCommands = initCommands;
+    _initState = (_rst >= 0) ? TFT_INIT_RESET_HIGH : TFT_INIT_COMMANDS;
+}
 
-    if (_rst >= 0)
+/*!
+    @brief   Carry out the next step of the initialization sequence started
+             by initSPIAsync(): a reset pin change, or the init commands up
+             to and including the next one with a delay.
+    @return  Microseconds to wait before calling again (the caller may do
+             other work meanwhile, but MUST NOT call sooner), 0 when the
+             sequence is complete.
+*/
+uint32_t Adafruit_SPITFT::initStep(void)
+{
+    switch (_initState)
     {
-        // Toggle _rst low to reset
+    case TFT_INIT_RESET_HIGH:
         pinMode(_rst, OUTPUT);
         digitalWrite(_rst, HIGH);
-        wait_ms(100);
-        digitalWrite(_rst, LOW);
-        wait_ms(100);
+        _initState = TFT_INIT_RESET_LOW;
+        if (_rstHighUs)
+            return _rstHighUs;
+        // Else fall through
+    case TFT_INIT_RESET_LOW:
+        digitalWrite(_rst, LOW); // Toggle _rst low to reset
+        _initState = TFT_INIT_RESET_END;
+        return _rstLowUs ? _rstLowUs : 1;
+    case TFT_INIT_RESET_END:
         digitalWrite(_rst, HIGH);
-        wait_ms(200);
+        _initState = TFT_INIT_COMMANDS;
+        if (_rstRecoverUs)
+            return _rstRecoverUs;
+        // Else fall through
+    case TFT_INIT_COMMANDS:
+        if (_initCommands)
+        {
+            uint8_t cmd, x;
+            while ((cmd = pgm_read_byte(_initCommands++)))
+            {
+                x = pgm_read_byte(_initCommands++);
+                uint8_t numArgs = x & ~TFT_INIT_DELAY;
+                sendCommand(cmd, _initCommands, numArgs);
+                _initCommands += numArgs;
+                if (x & TFT_INIT_DELAY)
+                {
+                    uint16_t ms = pgm_read_byte(_initCommands++);
+                    if (ms == 255)
+                        ms = 500; // If 255, delay for 500 ms
+                    return (uint32_t)ms * 1000;
+                }
+            }
+        }
+        _initState = TFT_INIT_IDLE;
+        // Fall through
+    default:
+        return 0;
     }
+}
 
-#if defined(USE_SPI_DMA)
-    // TODO: Implement DMA
-#endif // end USE_SPI_DMA
+/*!
+    @brief   Query whether the initialization sequence has completed.
+    @return  true if no initSPIAsync() sequence is in progress.
+*/
+bool Adafruit_SPITFT::initDone(void) const
+{
+    return _initState == TFT_INIT_IDLE;
+}
+
+/*!
+    @brief  Set the reset pulse timing used by initSPI() and
+            initSPIAsync(). Defaults (100 ms, 100 ms, 200 ms) are very
+            conservative; most controllers need only a few microseconds of
+            pulse and 5-120 ms of recovery (see the datasheet).
+    @param  highUs     Time reset is held high (inactive) before the pulse.
+    @param  lowUs      Reset pulse width.
+    @param  recoverUs  Time after the pulse before commands may be sent.
+*/
+void Adafruit_SPITFT::setResetTiming(uint32_t highUs, uint32_t lowUs, uint32_t recoverUs)
+{
+    _rstHighUs = highUs;
+    _rstLowUs = lowUs;
+    _rstRecoverUs = recoverUs;
 }
 
 /*!
@@ -255,9 +336,7 @@ void Adafruit_SPITFT::initSPI(void)
 */
 void Adafruit_SPITFT::startWrite(void)
 {
-    SPI_BEGIN_TRANSACTION();
-    if (_cs >= 0)
-        SPI_CS_LOW();
+    _bus->startWrite();
 }
 
 /*!
@@ -268,9 +347,7 @@ void Adafruit_SPITFT::startWrite(void)
 */
 void Adafruit_SPITFT::endWrite(void)
 {
-    if (_cs >= 0)
-        SPI_CS_HIGH();
-    SPI_END_TRANSACTION();
+    _bus->endWrite();
 }
 
 // -------------------------------------------------------------------------
@@ -323,7 +400,11 @@ void Adafruit_SPITFT::writePixel(int16_t x, int16_t y, uint16_t color)
                        some processing time here, ESPECIALLY if using this
                        function's non-blocking DMA mode. Not all cases are
                        covered...this is really here only for SAMD DMA and
-                       much forethought on the application side.
+                       much forethought on the application side. Big-endian
+                       pixels are issued straight from memory, and where
+                       SPI is asynchronous a non-blocking call returns once
+                       the transfer has started (the array must then be
+                       left alone until dmaWait()).
 */
 void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool block, bool bigEndian)
 {
@@ -334,41 +415,97 @@ void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool block, bo
         // TODO: Implement DMA
 #endif // end USE_SPI_DMA
 
-    if (connection == TFT_HARD_SPI)
-    {
-        uint32_t i = 0;
-        for (int remaining_bytes = 2 * len; remaining_bytes > 0; remaining_bytes -= SPI_BUFFER_SIZE)
+    if (bigEndian)
+    { // Already in display byte order, issue straight from memory
+        if (block)
         {
-            // Fill array of colors
-            for (uint8_t *ptr = (uint8_t *)spi_buffer; (ptr < (uint8_t *)(spi_buffer + SPI_BUFFER_SIZE)) && (i < len); ptr++)
-            {
-                *ptr++ = highByte(colors[i]);
-                *ptr = lowByte(colors[i++]);
-            }
-            // Write array of bytes to SPI
-            hwspi._spi->write((char *)spi_buffer, std::min(remaining_bytes, SPI_BUFFER_SIZE), (char *)NULL, 0);
+            dmaWait();
+            writeStaged((const uint8_t *)colors, len);
         }
+        else
+        {
+            writeStagedAsync((const uint8_t *)colors, len);
+        }
+        return;
     }
-    else
+
+    if (!spi_buffer)
+    { // No staging buffer (out of memory), issue a pixel at a time
+        for (uint32_t i = 0; i < len; i++)
+            _bus->write16(colors[i]);
+        return;
+    }
+
+    uint32_t i = 0;
+    for (int remaining_bytes = 2 * len; remaining_bytes > 0; remaining_bytes -= SPI_BUFFER_SIZE)
     {
-        // All other cases (bitbang SPI or non-DMA hard SPI or parallel),
-        // use a loop with the normal 16-bit data write function:
-        while (len--)
-            SPI_WRITE16(*colors++);
+        // Fill array of colors
+        for (uint8_t *ptr = (uint8_t *)spi_buffer; (ptr < (uint8_t *)(spi_buffer + SPI_BUFFER_SIZE)) && (i < len); ptr++)
+        {
+            *ptr++ = highByte(colors[i]);
+            *ptr = lowByte(colors[i++]);
+        }
+        // Write array of bytes to the bus
+        _bus->writeBytes(spi_buffer, std::min(remaining_bytes, SPI_BUFFER_SIZE));
     }
 }
 
+/*!
+    @brief  Issue pixels previously composed in the staging buffer. Not
+            self-contained; should follow startWrite() and setAddrWindow()
+            calls. The buffer is left intact, so the same pixels may be
+            issued repeatedly (e.g. to replicate a row).
+    @param  len  Number of pixels, stored as 16-bit values in display
+                 (big-endian) byte order at the start of the buffer. MUST
+                 NOT exceed SPI_BUFFER_SIZE / 2.
+*/
+void Adafruit_SPITFT::writeStaged(uint32_t len)
+{
+    writeStaged(spi_buffer, len);
+}
+
+/*!
+    @brief  Issue pixels previously composed in a buffer other than (or
+            part of) the staging buffer. Not self-contained; should follow
+            startWrite() and setAddrWindow() calls.
+    @param  buf  Pixels as 16-bit values in display (big-endian) byte order.
+    @param  len  Number of pixels.
+*/
+void Adafruit_SPITFT::writeStaged(const uint8_t *buf, uint32_t len)
+{
+    _bus->writeBytes(buf, 2 * len);
+}
+
+/*!
+    @brief  Start issuing pixels composed in a buffer. Where the bus
+            supports it (e.g. hardware SPI with asynchronous transfers),
+            returns as soon as the transfer has started (after any previous
+            one has finished), so the next chunk can be prepared meanwhile;
+            the buffer must not be touched until the transfer ends.
+            Otherwise same as writeStaged(). Not self-contained; should
+            follow startWrite() and setAddrWindow() calls, and dmaWait()
+            MUST be called before endWrite().
+    @param  buf  Pixels as 16-bit values in display (big-endian) byte order.
+    @param  len  Number of pixels.
+*/
+void Adafruit_SPITFT::writeStagedAsync(const uint8_t *buf, uint32_t len)
+{
+    _bus->writeBytesAsync(buf, 2 * len);
+}
+
 /*!
     @brief  Wait for the last DMA transfer in a prior non-blocking
             writePixels() call to complete. This does nothing if DMA
             is not enabled, and is not needed if blocking writePixels()
-            was used (as is the default case).
+            was used (as is the default case). Also waits for transfers
+            started by writeStagedAsync().
 */
 void Adafruit_SPITFT::dmaWait(void)
 {
 #if defined(USE_SPI_DMA)
     // TODO: Implement DMA
 #endif // end USE_SPI_DMA
+    _bus->wait();
 }
 
 /*!
@@ -386,67 +523,7 @@ void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len)
         // TODO: Implement DMA
 #endif // end USE_SPI_DMA
 
-    // All other cases (non-DMA hard SPI, bitbang SPI, parallel)...
-
-    if (connection == TFT_HARD_SPI)
-    {
-        // Fill array of colors
-        uint8_t hi = highByte(color), lo = lowByte(color);
-        if (hi == lo) // if hi byte equals low byte, set all bytes using memset
-        {
-            memset(spi_buffer, hi, SPI_BUFFER_SIZE);
-        }
-        else // otherwise, loop through buffer setting pairs of bytes
-        {
-            uint16_t data = SWAP_BYTES(color);
-            for (uint16_t *ptr = (uint16_t *)spi_buffer; ptr < (uint16_t *)(spi_buffer + SPI_BUFFER_SIZE); ptr++)
-                *ptr = data;
-        }
-        // Write array of bytes to SPI
-        for (int remaining_bytes = 2 * len; remaining_bytes > 0; remaining_bytes -= SPI_BUFFER_SIZE)
-            hwspi._spi->write((char *)spi_buffer, std::min(remaining_bytes, SPI_BUFFER_SIZE), (char *)NULL, 0);
-        /*
-        // Write each byte
-        while (len--)
-        {
-            hwspi._spi->write(hi);
-            hwspi._spi->write(lo);
-        }
-        */
-    }
-    else if (connection == TFT_SOFT_SPI)
-    {
-        while (len--)
-        {
-            // Bit-Bang the data out
-            for (uint16_t bit = 0, x = color; bit < 16; bit++)
-            {
-                if (x & 0x8000)
-                    SPI_MOSI_HIGH();
-                else
-                    SPI_MOSI_LOW();
-                SPI_SCK_HIGH();
-                x <<= 1;
-                SPI_SCK_LOW();
-            }
-        }
-    }
-    /*
-    // TODO: Implement Parallel
-    else
-    {   // TFT_PARALLEL
-        if (hi == lo)
-        {
-        }
-        else
-        {
-            while (len--)
-            {
-                TFT_WR_STROBE();
-            }
-        }
-    }
-    */
+    _bus->writeRepeat(color, len);
 }
 
 /*!
@@ -730,6 +807,77 @@ void Adafruit_SPITFT::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint1
     }
 }
 
+/*!
+    @brief  Fill many rectangles in one transaction, clipping each in line
+            (no per-rectangle virtual calls or transactions). No
+            transaction is started if none is on screen.
+    @param  rects   Rectangles, drawn in order (zero or negative sizes are
+                    skipped).
+    @param  colors  16-bit fill color of each rectangle, '565' RGB format.
+    @param  n       Number of rectangles.
+*/
+void Adafruit_SPITFT::fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n)
+{
+    bool started = false;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = rects[i].x, y = rects[i].y, w = rects[i].w, h = rects[i].h;
+        if (!clipRect(&x, &y, &w, &h))
+            continue;
+        if (!started)
+        {
+            startWrite();
+            started = true;
+        }
+        writeFillRectPreclipped(x, y, w, h, colors[i]);
+    }
+    if (started)
+        endWrite();
+}
+
+/*!
+    @brief  Draw many horizontal spans in one transaction, clipping each in
+            line. Consecutive spans stacked exactly on top of each other
+            (same position, width and color, next row) share one address
+            window.
+    @param  spans  Spans, drawn in order (zero or negative widths are
+                   skipped).
+    @param  n      Number of spans.
+*/
+void Adafruit_SPITFT::drawSpans(const GFXspan *spans, uint16_t n)
+{
+    int16_t px = 0, py = 0, pw = 0, ph = 0; // Pending window, ph = 0: none
+    uint16_t pc = 0;
+    bool started = false;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int16_t x = spans[i].x, y = spans[i].y, w = spans[i].w, h = 1;
+        if (!clipRect(&x, &y, &w, &h))
+            continue;
+        if (ph && (x == px) && (w == pw) && (spans[i].color == pc) && (y == py + ph))
+        {
+            ph++;
+            continue;
+        }
+        if (!started)
+        {
+            startWrite();
+            started = true;
+        }
+        if (ph)
+            writeFillRectPreclipped(px, py, pw, ph, pc);
+        px = x;
+        py = y;
+        pw = w;
+        ph = 1;
+        pc = spans[i].color;
+    }
+    if (ph)
+        writeFillRectPreclipped(px, py, pw, ph, pc);
+    if (started)
+        endWrite();
+}
+
 /*!
     @brief  Draw a horizontal line on the display. Self-contained and
             provides its own transaction as needed (see writeFastHLine() for
@@ -857,7 +1005,22 @@ void Adafruit_SPITFT::pushColor(uint16_t color)
 */
 void Adafruit_SPITFT::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h)
 {
+    drawRGBSubBitmap(x, y, pcolors, w, w, h);
+}
 
+/*!
+    @brief  Draw a rectangular region of a larger 16-bit image (565 RGB),
+            e.g. part of a canvas buffer. The region is a single address
+            window. Handles its own transaction and edge clipping/rejection.
+    @param  x        Top left corner horizontal coordinate.
+    @param  y        Top left corner vertical coordinate.
+    @param  pcolors  Pointer to the region's top left pixel.
+    @param  stride   Distance between rows of the image, in pixels.
+    @param  w        Width of region in pixels.
+    @param  h        Height of region in pixels.
+*/
+void Adafruit_SPITFT::drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t stride, int16_t w, int16_t h)
+{
     int16_t x2, y2;                 // Lower-right coord
     if ((x >= _width) ||            // Off-edge right
         (y >= _height) ||           // " top
@@ -865,8 +1028,7 @@ void Adafruit_SPITFT::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int
         ((y2 = (y + h - 1)) < 0))   // " bottom
         return;
 
-    int16_t bx1 = 0, by1 = 0, // Clipped top-left within bitmap
-        saveW = w;            // Save original bitmap width value
+    int16_t bx1 = 0, by1 = 0; // Clipped top-left within bitmap
     if (x < 0)
     { // Clip left
         w += x;
@@ -884,13 +1046,13 @@ void Adafruit_SPITFT::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int
     if (y2 >= _height)
         h = _height - y; // Clip bottom
 
-    pcolors += by1 * saveW + bx1; // Offset bitmap ptr to clipped top-left
+    pcolors += by1 * stride + bx1; // Offset bitmap ptr to clipped top-left
     startWrite();
     setAddrWindow(x, y, w, h); // Clipped area
-    if (saveW == w)
+    if (stride == w)
     {
         // Draw all-at-once
-        writePixels(pcolors, saveW * h); // Push all rows
+        writePixels(pcolors, w * h); // Push all rows
     }
     else
     {
@@ -898,9 +1060,119 @@ void Adafruit_SPITFT::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int
         while (h--)
         {                            // For each (clipped) scanline...
             writePixels(pcolors, w); // Push one (clipped) row
-            pcolors += saveW;        // Advance pointer by one full (unclipped) line
+            pcolors += stride;       // Advance pointer by one full (unclipped) line
+        }
+    }
+    endWrite();
+}
+
+/*!
+    @brief  Draw an already-clipped region of an image streamed from
+            external storage. The region is one address window; pixel data
+            is stored in display byte order and goes out as read. Chunks
+            alternate between the two halves of the staging buffer, so with
+            asynchronous SPI the next chunk is read from storage while the
+            previous one is being transmitted. Full-width regions are read
+            as one contiguous run rather than row by row. Handles its own
+            transaction.
+    @param  x      Top left corner horizontal coordinate, onscreen.
+    @param  y      Top left corner vertical coordinate, onscreen.
+    @param  image  Stored image.
+    @param  sx     Left edge of region within image.
+    @param  sy     Top edge of region within image.
+    @param  w      Width of region (within image and display).
+    @param  h      Height of region (within image and display).
+*/
+void Adafruit_SPITFT::drawImagePreclipped(int16_t x, int16_t y, GFXimage &image, int16_t sx, int16_t sy, int16_t w, int16_t h)
+{
+    if (!spi_buffer)
+    {
+        Adafruit_GFX::drawImagePreclipped(x, y, image, sx, sy, w, h);
+        return;
+    }
+
+    const uint32_t chunk = SPI_BUFFER_SIZE / 4; // Pixels per buffer half
+    uint8_t *half[2] = {spi_buffer, spi_buffer + SPI_BUFFER_SIZE / 2};
+    bool linear = (w == image.width());
+    uint32_t runLen = linear ? (uint32_t)w * h : w;
+    int16_t runs = linear ? 1 : h;
+    uint8_t n = 0;
+
+    startWrite();
+    setAddrWindow(x, y, w, h);
+    for (int16_t r = 0; r < runs; r++)
+    {
+        for (uint32_t i = 0; i < runLen; i += chunk, n ^= 1)
+        {
+            uint32_t len = std::min(runLen - i, chunk);
+            int16_t col = linear ? (i % w) : (sx + i),
+                    row = linear ? (sy + i / w) : (sy + r);
+            if (image.read(half[n], col, row, len))
+            {
+                r = runs; // Storage error, give up on the image
+                break;
+            }
+            writeStagedAsync(half[n], len);
         }
     }
+    dmaWait();
+    endWrite();
+}
+
+/*!
+    @brief  Draw an image through an affine map, within an already-clipped
+            area. Each row's span is composed into alternate halves of the
+            staging buffer, one run of drawn (unmasked) pixels per address
+            window, so the next run is composed while the last is sent.
+    @param  bitmap  w * h pixels
+    @param  mask    1 bit per pixel (see drawRGBBitmapTransformed()), or
+                    NULL
+    @param  w       Image width
+    @param  h       Image height
+    @param  m       Map from display to image positions
+    @param  area    Display area to draw in, MUST be onscreen
+*/
+void Adafruit_SPITFT::drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area)
+{
+    if (!spi_buffer)
+    {
+        Adafruit_GFX::drawRGBBitmapTransformedPreclipped(bitmap, mask, w, h, m, area);
+        return;
+    }
+
+    const int16_t chunk = SPI_BUFFER_SIZE / 4; // Pixels per buffer half
+    uint8_t *half[2] = {spi_buffer, spi_buffer + SPI_BUFFER_SIZE / 2};
+    int16_t maskStride = (w + 7) / 8;
+    uint8_t n = 0;
+
+    startWrite();
+    for (int16_t y = area.y; y < area.y + area.h; y++)
+    {
+        int16_t x0 = area.x, x1 = area.x + area.w - 1, start = 0, len = 0;
+        int32_t u, v;
+        if (!affineSpan(m, w, h, y, &x0, &x1, &u, &v))
+            continue;
+        for (int16_t x = x0; x <= x1; x++, u += m.a, v += m.c)
+        {
+            int16_t su = u >> 16, sv = v >> 16;
+            bool drawn = !mask || (pgm_read_byte(&mask[sv * maskStride + su / 8]) & (0x80 >> (su & 7)));
+            if (drawn)
+            {
+                if (!len)
+                    start = x;
+                ((uint16_t *)half[n])[len++] = SWAP_BYTES(pgm_read_word(&bitmap[sv * w + su]));
+            }
+            if (len && (!drawn || (len == chunk) || (x == x1)))
+            {
+                dmaWait(); // Window can't change under the last run
+                setAddrWindow(start, y, len, 1);
+                writeStagedAsync(half[n], len);
+                n ^= 1;
+                len = 0;
+            }
+        }
+    }
+    dmaWait();
     endWrite();
 }
 
@@ -948,7 +1220,161 @@ void Adafruit_SPITFT::drawXBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
                 *(((uint16_t *)spi_buffer) + i) = bg_color_data;
         }
         setAddrWindow(x, y, w, 1); // Clipped area
-        hwspi._spi->write((char *)spi_buffer, 2 * w, (char *)NULL, 0);
+        writeStaged(w);
+    }
+    endWrite();
+}
+
+/*!
+    @brief  Draw a single character of the 'classic' built-in font, pushing
+            the character cell (or each run of set pixels, for transparent
+            text) as one address window rather than one window per pixel.
+            Handles its own transaction and edge clipping/rejection.
+    @param  x       Left edge of character cell.
+    @param  y       Top edge of character cell.
+    @param  c       Index into the built-in font (CP437 setting applied).
+    @param  color   16-bit character color in '565' RGB format.
+    @param  bg      16-bit background color in '565' RGB format (if same as
+                    color, no background).
+    @param  size_x  Font magnification level in X-axis, 1 is 'original'.
+    @param  size_y  Font magnification level in Y-axis, 1 is 'original'.
+    @note   Addresses are in the current rotation. Subclasses program the
+            panel's scan direction in setRotation(), so a cell composed
+            here in logical order is already in the order the panel expects
+            and rotated (90/270) text costs no more than unrotated text.
+*/
+void Adafruit_SPITFT::drawClassicChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
+{
+    int16_t x0, y0, x1, y1; // Visible cell range
+
+    if (!charClip(x, y, 6, 8, size_x, size_y, &x0, &y0, &x1, &y1))
+        return;
+
+    uint8_t cols[6]; // Char bitmap = 5 columns + blank spacing column
+    for (int16_t i = 0; i < 5; i++)
+        cols[i] = classicFontColumn(c, i);
+    cols[5] = 0;
+
+    if (bg != color)
+    {
+        // Opaque: the whole magnified cell (clipped) is one window.
+        // Each font row is expanded horizontally into the staging
+        // buffer once, then issued once per screen row it covers.
+        int16_t cx0 = (x < 0) ? 0 : x,
+                cy0 = (y < 0) ? 0 : y,
+                cx1 = x + 6 * size_x - 1,
+                cy1 = y + 8 * size_y - 1;
+        if (cx1 >= _width)
+            cx1 = _width - 1;
+        if (cy1 >= _height)
+            cy1 = _height - 1;
+        int16_t cw = cx1 - cx0 + 1;
+        if (!spi_buffer || (cw > (SPI_BUFFER_SIZE / 2)))
+        { // Row doesn't fit the staging buffer
+            Adafruit_GFX::drawClassicChar(x, y, c, color, bg, size_x, size_y);
+            return;
+        }
+
+        uint16_t fg_data = SWAP_BYTES(color), bg_data = SWAP_BYTES(bg);
+        startWrite();
+        setAddrWindow(cx0, cy0, cw, cy1 - cy0 + 1);
+        for (int16_t j = y0; j <= y1; j++)
+        {
+            uint16_t *ptr = (uint16_t *)spi_buffer;
+            for (int16_t i = x0; i <= x1; i++)
+            {
+                int16_t p0 = x + i * size_x, p1 = p0 + size_x - 1;
+                if (p0 < cx0)
+                    p0 = cx0;
+                if (p1 > cx1)
+                    p1 = cx1;
+                uint16_t data = ((cols[i] >> j) & 1) ? fg_data : bg_data;
+                for (; p0 <= p1; p0++)
+                    *ptr++ = data;
+            }
+            int16_t r0 = y + j * size_y, r1 = r0 + size_y - 1;
+            if (r0 < cy0)
+                r0 = cy0;
+            if (r1 > cy1)
+                r1 = cy1;
+            for (; r0 <= r1; r0++) // Row replication
+                writeStaged(cw);
+        }
+        endWrite();
+    }
+    else
+    {
+        // Transparent: font is column-major, so push vertical runs.
+        startWrite();
+        for (int16_t i = x0; (i <= x1) && (i < 5); i++)
+        {
+            uint8_t line = cols[i] >> y0;
+            int16_t run = 0;
+            for (int16_t j = y0; j <= y1; j++, line >>= 1)
+            {
+                if (line & 1)
+                {
+                    run++;
+                }
+                else if (run)
+                {
+                    writeFillRect(x + i * size_x, y + (j - run) * size_y, size_x, run * size_y, color);
+                    run = 0;
+                }
+            }
+            if (run)
+                writeFillRect(x + i * size_x, y + (y1 + 1 - run) * size_y, size_x, run * size_y, color);
+        }
+        endWrite();
+    }
+}
+
+/*!
+    @brief  Draw a custom (GFXfont or streamed) font glyph. Each horizontal
+            run of set pixels in a glyph row becomes a single
+            (size_x * run) by size_y window. Handles its own transaction
+            and edge clipping/rejection.
+    @param  x       Cursor x coordinate (glyph offsets are relative to this).
+    @param  y       Cursor y coordinate, on the baseline.
+    @param  glyph   Glyph metrics, RAM-resident.
+    @param  bitmap  This glyph's bitmap (first byte).
+    @param  color   16-bit glyph color in '565' RGB format.
+    @param  size_x  Font magnification level in X-axis, 1 is 'original'.
+    @param  size_y  Font magnification level in Y-axis, 1 is 'original'.
+*/
+void Adafruit_SPITFT::drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint16_t color, uint8_t size_x, uint8_t size_y)
+{
+    int16_t x0, y0, x1, y1; // Visible cell range
+    uint8_t w = glyph->width, h = glyph->height;
+
+    x += glyph->xOffset * size_x; // Glyph UL corner
+    y += glyph->yOffset * size_y;
+    if (!w || !h || !charClip(x, y, w, h, size_x, size_y, &x0, &y0, &x1, &y1))
+        return;
+
+    startWrite();
+    for (int16_t yy = y0; yy <= y1; yy++)
+    {
+        uint16_t bit = yy * w + x0;
+        uint8_t bits = pgm_read_byte(&bitmap[bit >> 3]) << (bit & 7);
+        int16_t run = 0;
+        for (int16_t xx = x0; xx <= x1; xx++, bit++)
+        {
+            if (!(bit & 7))
+                bits = pgm_read_byte(&bitmap[bit >> 3]);
+            if (bits & 0x80)
+            {
+                run++;
+            }
+            else if (run)
+            {
+                writeFillRect(x + (xx - run) * size_x, y + yy * size_y, run * size_x, size_y, color);
+                run = 0;
+            }
+            bits <<= 1;
+        }
+        if (run)
+            writeFillRect(x + (x1 + 1 - run) * size_x, y + yy * size_y, run * size_x, size_y, color);
     }
     endWrite();
 }
@@ -988,75 +1414,18 @@ uint16_t Adafruit_SPITFT::color565(uint8_t red, uint8_t green, uint8_t blue)
 // compile to different things based on #defines -- typically just a few
 // instructions. Others, not so much, those are not inlined.
 
-/*!
-    @brief  Start an SPI transaction if using the hardware SPI interface to
-            the display. If using an earlier version of the Arduino platform
-            (before the addition of SPI transactions), this instead attempts
-            to set up the SPI clock and mode. No action is taken if the
-            connection is not hardware SPI-based. This does NOT include a
-            chip-select operation -- see startWrite() for a function that
-            encapsulated both actions.
-*/
-inline void Adafruit_SPITFT::SPI_BEGIN_TRANSACTION(void)
-{
-    /*
-    if (connection == TFT_HARD_SPI)
-    {
-        hwspi._spi->format(hwspi._bits, hwspi._mode);
-        hwspi._spi->frequency(hwspi._freq);
-    }
-    */
-}
-
-/*!
-    @brief  End an SPI transaction if using the hardware SPI interface to
-            the display. No action is taken if the connection is not
-            hardware SPI-based or if using an earlier version of the Arduino
-            platform (before the addition of SPI transactions). This does
-            NOT include a chip-deselect operation -- see endWrite() for a
-            function that encapsulated both actions.
-*/
-inline void Adafruit_SPITFT::SPI_END_TRANSACTION(void)
-{
-}
-
 /*!
     @brief  Issue a single 8-bit value to the display. Chip-select,
             transaction and data/command selection must have been
             previously set -- this ONLY issues the byte. This is another of
             those functions in the library with a now-not-accurate name
             that's being maintained for compatibility with outside code.
-            This function is used even if display connection is parallel.
+            This function is used whatever the display connection.
     @param  b  8-bit value to write.
 */
 void Adafruit_SPITFT::SPI_WRITE8(uint8_t b)
 {
-    if (connection == TFT_HARD_SPI)
-    {
-        // Write a byte of data
-        hwspi._spi->write(b);
-    }
-    else if (connection == TFT_SOFT_SPI)
-    {
-        // Bit-Bang the data out
-        for (uint8_t bit = 0; bit < 8; bit++)
-        {
-            if (b & 0x80)
-                SPI_MOSI_HIGH();
-            else
-                SPI_MOSI_LOW();
-            SPI_SCK_HIGH();
-            b <<= 1;
-            SPI_SCK_LOW();
-        }
-    }
-    /*
-    // TODO: Implement Parallel
-    else
-    {   // TFT_PARALLEL
-        TFT_WR_STROBE();
-    }
-    */
+    _bus->write8(b);
 }
 
 /*!
@@ -1069,9 +1438,24 @@ void Adafruit_SPITFT::SPI_WRITE8(uint8_t b)
 */
 void Adafruit_SPITFT::writeCommand(uint8_t cmd)
 {
-    SPI_DC_LOW();
-    SPI_WRITE8(cmd);
-    SPI_DC_HIGH();
+    _bus->writeCommand(cmd);
+}
+
+/*!
+    @brief  Send a command with its argument bytes. Self-contained,
+            includes its own transaction.
+    @param  cmd   The command byte.
+    @param  data  Argument bytes (PROGMEM-resident or RAM, read with
+                  pgm_read_byte()).
+    @param  len   Number of argument bytes.
+*/
+void Adafruit_SPITFT::sendCommand(uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    startWrite();
+    writeCommand(cmd);
+    while (len--)
+        SPI_WRITE8(pgm_read_byte(data++));
+    endWrite();
 }
 
 /*!
@@ -1079,203 +1463,37 @@ void Adafruit_SPITFT::writeCommand(uint8_t cmd)
              transaction must have been previously set -- this ONLY reads
              the byte. This is another of those functions in the library
              with a now-not-accurate name that's being maintained for
-             compatibility with outside code. This function is used even if
-             display connection is parallel.
+             compatibility with outside code. This function is used
+             whatever the display connection (0 if the bus can't read).
     @return  Unsigned 8-bit value read
 */
 uint8_t Adafruit_SPITFT::SPI_READ8(void)
 {
-    uint8_t b = 0;
-    if (connection == TFT_HARD_SPI)
-    {
-        // Read a byte of data
-        return hwspi._spi->write((uint8_t)0);
-    }
-    else if (connection == TFT_SOFT_SPI)
-    {
-        if (swspi._miso >= 0)
-        {
-            // Bit-Bang the data in
-            for (uint8_t i = 0; i < 8; i++)
-            {
-                SPI_SCK_HIGH();
-                b <<= 1;
-                if (SPI_MISO_READ())
-                    b++;
-                SPI_SCK_LOW();
-            }
-        }
-        return b;
-    }
-    /*
-    // TODO: Implement Parallel
-    else
-    {   // TFT_PARALLEL
-        uint16_t w = 0;
-        if (tft8._rd >= 0)
-            w = 0;
-        return w;
-    }
-    */
-    return 0;
-}
-
-/*!
-    @brief  Set the software (bitbang) SPI MOSI line HIGH.
-*/
-inline void Adafruit_SPITFT::SPI_MOSI_HIGH(void)
-{
-    digitalWrite(swspi._mosi, HIGH);
-}
-
-/*!
-    @brief  Set the software (bitbang) SPI MOSI line LOW.
-*/
-inline void Adafruit_SPITFT::SPI_MOSI_LOW(void)
-{
-    digitalWrite(swspi._mosi, LOW);
-}
-
-/*!
-    @brief  Set the software (bitbang) SPI SCK line HIGH.
-*/
-inline void Adafruit_SPITFT::SPI_SCK_HIGH(void)
-{
-    digitalWrite(swspi._sck, HIGH);
-}
-
-/*!
-    @brief  Set the software (bitbang) SPI SCK line LOW.
-*/
-inline void Adafruit_SPITFT::SPI_SCK_LOW(void)
-{
-    digitalWrite(swspi._sck, LOW);
-}
-
-/*!
-    @brief   Read the state of the software (bitbang) SPI MISO line.
-    @return  true if HIGH, false if LOW.
-*/
-inline bool Adafruit_SPITFT::SPI_MISO_READ(void)
-{
-    return digitalRead(swspi._miso);
+    return _bus->read8();
 }
 
 /*!
     @brief  Issue a single 16-bit value to the display. Chip-select,
             transaction and data/command selection must have been
             previously set -- this ONLY issues the word. Despite the name,
-            this function is used even if display connection is parallel;
-            name was maintaned for backward compatibility.
+            this function is used whatever the display connection; name was
+            maintaned for backward compatibility.
     @param  w  16-bit value to write.
 */
 void Adafruit_SPITFT::SPI_WRITE16(uint16_t w)
 {
-    if (connection == TFT_HARD_SPI)
-    {
-        uint8_t data[] = {(uint8_t)(w >> 8), (uint8_t)w};
-        // Write data
-        hwspi._spi->write((char *)data, sizeof(data), (char *)NULL, 0);
-        /*
-        // Write hi byte
-        hwspi._spi->write(highByte(w));
-        // Write lo byte
-        hwspi._spi->write(lowByte(w));
-        */
-    }
-    else if (connection == TFT_SOFT_SPI)
-    {
-        // Bit-Bang the data out
-        for (uint8_t bit = 0; bit < 16; bit++)
-        {
-            if (w & 0x8000)
-                SPI_MOSI_HIGH();
-            else
-                SPI_MOSI_LOW();
-            SPI_SCK_HIGH();
-            SPI_SCK_LOW();
-            w <<= 1;
-        }
-    }
-    /*
-    // TODO: Implement Parallel
-    else
-    {   // TFT_PARALLEL
-        TFT_WR_STROBE();
-    }
-    */
+    _bus->write16(w);
 }
 
 /*!
     @brief  Issue a single 32-bit value to the display. Chip-select,
             transaction and data/command selection must have been
             previously set -- this ONLY issues the longword. Despite the
-            name, this function is used even if display connection is
-            parallel; name was maintaned for backward compatibility.
+            name, this function is used whatever the display connection;
+            name was maintaned for backward compatibility.
     @param  l  32-bit value to write.
 */
 void Adafruit_SPITFT::SPI_WRITE32(uint32_t l)
 {
-    if (connection == TFT_HARD_SPI)
-    {
-        uint8_t data[] = {(uint8_t)(l >> 24), (uint8_t)(l >> 16), (uint8_t)(l >> 8), (uint8_t)l};
-        // Write data
-        hwspi._spi->write((char *)data, sizeof(data), (char *)NULL, 0);
-        /*
-        // Write out 4 bytes of data
-        hwspi._spi->write((uint8_t)(l >> 24));
-        hwspi._spi->write((uint8_t)(l >> 16));
-        hwspi._spi->write((uint8_t)(l >> 8));
-        hwspi._spi->write((uint8_t)l);
-        */
-    }
-    else if (connection == TFT_SOFT_SPI)
-    {
-        // Bit-Bang the data out
-        for (uint8_t bit = 0; bit < 32; bit++)
-        {
-            if (l & 0x80000000)
-                SPI_MOSI_HIGH();
-            else
-                SPI_MOSI_LOW();
-            SPI_SCK_HIGH();
-            SPI_SCK_LOW();
-            l <<= 1;
-        }
-    }
-    /*
-    // TODO: Implement Parallel
-    else
-    {   // TFT_PARALLEL
-        TFT_WR_STROBE();
-    }
-    */
-}
-
-/*!
-    @brief  Set the WR line LOW, then HIGH. Used for parallel-connected
-            interfaces when writing data.
-*/
-inline void Adafruit_SPITFT::TFT_WR_STROBE(void)
-{
-    digitalWrite(tft8._wr, LOW);
-    digitalWrite(tft8._wr, HIGH);
-}
-
-/*!
-    @brief  Set the RD line HIGH. Used for parallel-connected interfaces
-            when reading data.
-*/
-inline void Adafruit_SPITFT::TFT_RD_HIGH(void)
-{
-    digitalWrite(tft8._rd, HIGH);
-}
-
-/*!
-    @brief  Set the RD line LOW. Used for parallel-connected interfaces
-            when reading data.
-*/
-inline void Adafruit_SPITFT::TFT_RD_LOW(void)
-{
-    digitalWrite(tft8._rd, LOW);
+    _bus->write32(l);
 }
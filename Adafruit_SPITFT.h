@@ -22,10 +22,11 @@
 
 #include <SPI.h>
 #include "Adafruit_GFX.h"
+#include "GFXbus.h"
 
 // HARDWARE CONFIG ---------------------------------------------------------
 
-#define DEFAULT_SPI_FREQ 16000000L ///< Hardware SPI default speed
+#define TFT_INIT_DELAY 0x80 ///< Init command table: delay byte follows args
 
 //#define USE_SPI_DMA               ///< If set, use DMA if available
 
@@ -92,13 +93,21 @@ public:
 	// and optional reset pin. cs is required but can be NC if unused.
 	Adafruit_SPITFT(uint16_t w, uint16_t h, SPI &spi, PinName cs, PinName dc, PinName rst = NC, int bits = 8, int mode = 0, uint32_t freq = DEFAULT_SPI_FREQ);
 
+	// Constructor for any other connection: expects width & height
+	// (rotation 0), a display bus (see GFXbus.h; parallel ports, DMA
+	// engines, mocks for tests...) and optional reset pin. The bus MUST
+	// outlive the display object.
+	Adafruit_SPITFT(uint16_t w, uint16_t h, GFXbus &bus, PinName rst = NC);
+
+	~Adafruit_SPITFT(void);
+
 	// Parallel constructor: expects width & height (rotation 0), flag
 	// indicating whether 16-bit (true) or 8-bit (false) interface, 3 signal
 	// pins (d0, wr, dc), 3 optional pins (cs, rst, rd). 16-bit parallel
 	// isn't even fully implemented but the 'wide' flag was added as a
 	// required argument to avoid ambiguity with other constructors.
 	/*
-    // TODO: Implement Parallel
+    // TODO: Implement Parallel (as a GFXbus, for the bus constructor)
 	Adafruit_SPITFT(uint16_t w, uint16_t h, tftBusWidth busWidth, PinName d0, PinName wr, PinName dc, PinName cs = NC, PinName rst = NC, PinName rd = NC);
 	*/
 
@@ -132,6 +141,13 @@ public:
 	// Subclass' begin() function invokes this to initialize hardware.
 	// Name is outdated (interface may be parallel) but for compatibility:
 	void initSPI(void);
+	// Non-blocking equivalent: sets up pins, then initStep() (called until
+	// it returns 0) resets the display and sends an init command table:
+	void initSPIAsync(const uint8_t *initCommands = NULL);
+	uint32_t initStep(void);
+	bool initDone(void) const;
+	// Reset pulse timing, defaults are conservative (400 ms total):
+	void setResetTiming(uint32_t highUs, uint32_t lowUs, uint32_t recoverUs);
 	// Chip select and/or hardware SPI transaction start as needed:
 	void startWrite(void);
 	// Chip deselect and/or hardware SPI transaction end as needed:
@@ -167,6 +183,8 @@ public:
 	// higher-level primitives (which should use the functions above).
 	void drawPixel(int16_t x, int16_t y, uint16_t color);
 	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillRects(const GFXrect *rects, const uint16_t *colors, uint16_t n);
+	void drawSpans(const GFXspan *spans, uint16_t n);
 	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
 	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
 
@@ -177,13 +195,20 @@ public:
 
 	using Adafruit_GFX::drawRGBBitmap; // Check base class first
 	void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h);
+	void drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t stride, int16_t w, int16_t h);
 	void drawXBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t fg_color, uint16_t bg_color);
+	void drawClassicChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+	void drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint16_t color, uint8_t size_x, uint8_t size_y);
+	void drawImagePreclipped(int16_t x, int16_t y, GFXimage &image, int16_t sx, int16_t sy, int16_t w, int16_t h);
+	void drawRGBBitmapTransformedPreclipped(const uint16_t *bitmap, const uint8_t *mask, int16_t w, int16_t h, const GFXaffine &m, const GFXrect &area);
 
 	void invertDisplay(bool i);
 	uint16_t color565(uint8_t r, uint8_t g, uint8_t b);
 
 	// Despite parallel additions, function names kept for compatibility:
 	void writeCommand(uint8_t cmd); // Write single byte as COMMAND
+	// Command plus arguments, with transaction:
+	void sendCommand(uint8_t cmd, const uint8_t *data, uint8_t len);
 
 	void SPI_WRITE8(uint8_t b);   // Write 8-bits (single byte) as DATA
 	void SPI_WRITE16(uint16_t w); // Write 16-bits (two bytes) as DATA
@@ -196,25 +221,23 @@ public:
 	}
 
 	/*!
-        @brief  Set the chip-select line HIGH. Does NOT check whether CS pin
-                is set (>=0), that should be handled in calling function.
-                Despite function name, this is used even if the display
-                connection is parallel.
+        @brief  Deselect the display (chip-select line HIGH, if the bus has
+                one). Despite function name, this is used whatever the
+                display connection.
     */
 	void SPI_CS_HIGH(void)
 	{
-		_cs = HIGH;
+		_bus->chipSelect(false);
 	}
 
 	/*!
-        @brief  Set the chip-select line LOW. Does NOT check whether CS pin
-                is set (>=0), that should be handled in calling function.
-                Despite function name, this is used even if the display
-                connection is parallel.
+        @brief  Select the display (chip-select line LOW, if the bus has
+                one). Despite function name, this is used whatever the
+                display connection.
     */
 	void SPI_CS_LOW(void)
 	{
-		_cs = LOW;
+		_bus->chipSelect(true);
 	}
 
 	/*!
@@ -222,7 +245,7 @@ public:
     */
 	void SPI_DC_HIGH(void)
 	{
-		_dc = HIGH;
+		_bus->dataMode(true);
 	}
 
 	/*!
@@ -230,64 +253,32 @@ public:
     */
 	void SPI_DC_LOW(void)
 	{
-		_dc = LOW;
+		_bus->dataMode(false);
+	}
+
+	/*!
+        @brief   Get the bus the display is connected by.
+        @return  Display bus.
+    */
+	GFXbus &bus(void)
+	{
+		return *_bus;
 	}
 
 protected:
-	// A few more low-level member functions -- some may have previously
-	// been macros. Shouldn't have a need to access these externally, so
-	// they've been moved to the protected section. Additionally, they're
-	// declared inline here and the code is in the .cpp file, since outside
-	// code doesn't need to see these.
-	inline void SPI_MOSI_HIGH(void);
-	inline void SPI_MOSI_LOW(void);
-	inline void SPI_SCK_HIGH(void);
-	inline void SPI_SCK_LOW(void);
-	inline bool SPI_MISO_READ(void);
-	inline void SPI_BEGIN_TRANSACTION(void);
-	inline void SPI_END_TRANSACTION(void);
-	inline void TFT_WR_STROBE(void); // Parallel interface write strobe
-	inline void TFT_RD_HIGH(void);   // Parallel interface read high
-	inline void TFT_RD_LOW(void);	// Parallel interface read low
+	// Issue pixels already composed (big-endian) in the staging buffer:
+	void writeStaged(uint32_t len);
+	void writeStaged(const uint8_t *buf, uint32_t len);
+	// Same, returning before the transfer ends where the bus can
+	// (buffer MUST then be left alone until dmaWait()):
+	void writeStagedAsync(const uint8_t *buf, uint32_t len);
 
 	// CLASS INSTANCE VARIABLES --------------------------------------------
 
-	// Here be dragons! There's a big union of three structures here --
-	// one each for hardware SPI, software (bitbang) SPI, and parallel
-	// interfaces. This is to save some memory, since a display's connection
-	// will be only one of these. The order of some things is a little weird
-	// in an attempt to get values to align and pack better in RAM.
-
-#if defined(__cplusplus) && (__cplusplus >= 201100)
-	union {
-#endif
-		struct
-		{					//   Values specific to HARDWARE SPI:
-			SPI *_spi;		///< SPI class pointer
-			int _bits = 8;  ///< SPI Bits per frame (4 - 16).  Default: 8
-			int _mode = 0;  ///< SPI Mode: Clock polarity and phase (0 - 3).  Default: 0
-			uint32_t _freq; ///< SPI bitrate (if no SPI transactions)
-		} hwspi;			///< Hardware SPI values
-		struct
-		{				   //   Values specific to SOFTWARE SPI:
-			PinName _mosi; ///< MOSI pin #
-			PinName _miso; ///< MISO pin #
-			PinName _sck;  ///< SCK pin #
-		} swspi;		   ///< Software SPI values
-		struct
-		{				   //   Values specific to 8-bit parallel:
-			PinName _d0;   ///< Data pin 0 #
-			PinName _wr;   ///< Write strobe pin #
-			PinName _rd;   ///< Read strobe pin # (or NC)
-			bool wide = 0; ///< If true, is 16-bit interface
-		} tft8;			   ///< Parallel interface settings
-#if defined(__cplusplus) && (__cplusplus >= 201100)
-	}; ///< Only one interface is active
-#endif
-	uint8_t connection; ///< TFT_HARD_SPI, TFT_SOFT_SPI, etc.
-	DigitalInOut _rst;  ///< Reset pin # (or NC)
-	DigitalInOut _cs;   ///< Chip select pin # (or NC)
-	DigitalInOut _dc;   ///< Data/command pin #
+	GFXbus *_bus;	  ///< Display connection; all I/O goes through it
+	uint8_t *spi_buffer = NULL; ///< Staging buffer for pixel data, this display's own (allocated by initSPIAsync())
+	bool _ownBus;	  ///< If set, _bus was created by a legacy constructor
+	DigitalInOut _rst; ///< Reset pin # (or NC)
 
 	int16_t _w, _h;
 	int16_t _xstart = 0;		  ///< Internal framebuffer X offset
@@ -296,6 +287,12 @@ protected:
 	uint8_t invertOffCommand = 0; ///< Command to disable invert mode
 
 	uint32_t _freq = 0; ///< Dummy var to keep subclasses happy
+
+	const uint8_t *_initCommands = NULL; ///< Next init table entry
+	uint8_t _initState = 0;				 ///< Init sequence step
+	uint32_t _rstHighUs = 100000;		 ///< Reset idle time before pulse
+	uint32_t _rstLowUs = 100000;		 ///< Reset pulse width
+	uint32_t _rstRecoverUs = 200000;	 ///< Reset recovery time
 };
 
 #endif // end _ADAFRUIT_SPITFT_H_
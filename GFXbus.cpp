@@ -0,0 +1,554 @@
+/*!
+ * @file GFXbus.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Display buses.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXbus.h"
+
+// GENERIC BUS -------------------------------------------------------------
+
+/*!
+    @brief  Set up the bus hardware. Called by Adafruit_SPITFT::initSPI().
+            The generic version deselects the display and selects data
+            mode.
+*/
+void GFXbus::begin(void)
+{
+    chipSelect(false);
+    dataMode(true);
+}
+
+/*!
+    @brief  Start a series of commands and data (select the display, and
+            claim the bus if shared).
+*/
+void GFXbus::startWrite(void)
+{
+    chipSelect(true);
+}
+
+/*!
+    @brief  End a series of commands and data.
+*/
+void GFXbus::endWrite(void)
+{
+    chipSelect(false);
+}
+
+/*!
+    @brief  Send a command byte, leaving the bus in data mode.
+    @param  cmd  Command byte.
+*/
+void GFXbus::writeCommand(uint8_t cmd)
+{
+    dataMode(false);
+    write8(cmd);
+    dataMode(true);
+}
+
+/*!
+    @brief  Send a 16-bit value, most significant byte first.
+    @param  w  Value to send.
+*/
+void GFXbus::write16(uint16_t w)
+{
+    uint8_t data[] = {(uint8_t)(w >> 8), (uint8_t)w};
+    writeBytes(data, sizeof(data));
+}
+
+/*!
+    @brief  Send a 32-bit value, most significant byte first.
+    @param  l  Value to send.
+*/
+void GFXbus::write32(uint32_t l)
+{
+    uint8_t data[] = {(uint8_t)(l >> 24), (uint8_t)(l >> 16), (uint8_t)(l >> 8), (uint8_t)l};
+    writeBytes(data, sizeof(data));
+}
+
+/*!
+    @brief  Send one 16-bit color repeatedly. The generic version stages a
+            short run of the color and sends it as many times as needed.
+    @param  color  16-bit color.
+    @param  len    Number of pixels.
+*/
+void GFXbus::writeRepeat(uint16_t color, uint32_t len)
+{
+    uint8_t run[GFX_BUS_REPEAT_CHUNK * 2];
+    uint32_t n = (len < GFX_BUS_REPEAT_CHUNK) ? len : GFX_BUS_REPEAT_CHUNK;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        run[2 * i] = color >> 8;
+        run[2 * i + 1] = color;
+    }
+    for (; len > n; len -= n)
+        writeBytes(run, 2 * n);
+    writeBytes(run, 2 * len);
+}
+
+/*!
+    @brief  Start sending a burst of bytes, returning before it's sent
+            where the bus can. Waits for any previous burst first. The
+            buffer MUST be left alone until wait(). The generic version
+            just calls writeBytes().
+    @param  buf  Bytes to send.
+    @param  len  Number of bytes.
+*/
+void GFXbus::writeBytesAsync(const uint8_t *buf, uint32_t len)
+{
+    writeBytes(buf, len);
+}
+
+/*!
+    @brief  Wait for the burst started by writeBytesAsync() to be sent.
+*/
+void GFXbus::wait(void)
+{
+}
+
+/*!
+    @brief   Read a byte from the display, on buses that can.
+    @return  Byte read (0 if the bus can't read).
+*/
+uint8_t GFXbus::read8(void)
+{
+    return 0;
+}
+
+// HARDWARE SPI ------------------------------------------------------------
+
+/*!
+    @brief  GFXspiBus constructor. Pins are set up by begin().
+    @param  spi     SPI peripheral.
+    @param  cs      Chip select pin (NC if unused, tie CS low).
+    @param  dc      Data/command select pin (required).
+    @param  bits    SPI bits per frame (4 - 16, default: 8).
+    @param  mode    SPI mode (default: 0).
+    @param  freq    SPI frequency.
+    @param  ownSpi  true to delete spi with the bus (if it was created
+                    with new for the bus alone).
+*/
+GFXspiBus::GFXspiBus(SPI &spi, PinName cs, PinName dc, int bits, int mode, uint32_t freq, bool ownSpi)
+    : _spi(&spi), _ownSpi(ownSpi), _cs(cs), _dc(dc), _bits(bits), _mode(mode), _freq(freq), _repeat(NULL), _repeatColor(0), _repeatFull(false)
+{
+#if DEVICE_SPI_ASYNCH
+    _busy = false;
+#endif
+}
+
+/*!
+    @brief  GFXspiBus destructor. Frees the repeat staging buffer, and the
+            SPI peripheral if owned.
+*/
+GFXspiBus::~GFXspiBus(void)
+{
+    wait();
+    if (_repeat)
+        free(_repeat);
+    if (_ownSpi)
+        delete _spi;
+}
+
+/*!
+    @brief  Set up pins and the SPI format and frequency, and allocate the
+            writeRepeat() staging buffer.
+*/
+void GFXspiBus::begin(void)
+{
+    if (!_repeat)
+        _repeat = (uint8_t *)malloc(GFX_SPI_REPEAT_BYTES);
+    if (_cs.is_connected())
+        pinMode(_cs, OUTPUT);
+    pinMode(_dc, OUTPUT);
+    GFXbus::begin();
+    _spi->format(_bits, _mode);
+    _spi->frequency(_freq);
+}
+
+/*!
+    @brief  Select or deselect the display.
+    @param  active  true to select.
+*/
+void GFXspiBus::chipSelect(bool active)
+{
+    wait(); // Let any asynchronous burst finish first
+    if (_cs.is_connected())
+        _cs = active ? LOW : HIGH;
+}
+
+/*!
+    @brief  Set the data/command line.
+    @param  data  true for data, false for commands.
+*/
+void GFXspiBus::dataMode(bool data)
+{
+    wait();
+    _dc = data ? HIGH : LOW;
+}
+
+/*!
+    @brief  Send one byte.
+    @param  b  Byte to send.
+*/
+void GFXspiBus::write8(uint8_t b)
+{
+    wait();
+    _spi->write(b);
+}
+
+/*!
+    @brief  Send a 16-bit value as one transfer, most significant byte
+            first.
+    @param  w  Value to send.
+*/
+void GFXspiBus::write16(uint16_t w)
+{
+    wait();
+    uint8_t data[] = {(uint8_t)(w >> 8), (uint8_t)w};
+    _spi->write((char *)data, sizeof(data), (char *)NULL, 0);
+}
+
+/*!
+    @brief  Send a 32-bit value as one transfer, most significant byte
+            first.
+    @param  l  Value to send.
+*/
+void GFXspiBus::write32(uint32_t l)
+{
+    wait();
+    uint8_t data[] = {(uint8_t)(l >> 24), (uint8_t)(l >> 16), (uint8_t)(l >> 8), (uint8_t)l};
+    _spi->write((char *)data, sizeof(data), (char *)NULL, 0);
+}
+
+/*!
+    @brief  Send a burst of bytes as one transfer.
+    @param  buf  Bytes to send.
+    @param  len  Number of bytes.
+*/
+void GFXspiBus::writeBytes(const uint8_t *buf, uint32_t len)
+{
+    wait();
+    _spi->write((const char *)buf, len, (char *)NULL, 0);
+}
+
+/*!
+    @brief  Send one 16-bit color repeatedly, in transfers of up to
+            GFX_SPI_REPEAT_BYTES from a staging buffer filled once per
+            color (with memset() where both bytes match). Falls back to the
+            generic version if the buffer couldn't be allocated.
+    @param  color  16-bit color.
+    @param  len    Number of pixels.
+*/
+void GFXspiBus::writeRepeat(uint16_t color, uint32_t len)
+{
+    if (!_repeat)
+    {
+        GFXbus::writeRepeat(color, len);
+        return;
+    }
+
+    uint32_t bytes = 2 * len;
+    uint32_t n = (bytes < GFX_SPI_REPEAT_BYTES) ? bytes : GFX_SPI_REPEAT_BYTES;
+    if (!_repeatFull || (color != _repeatColor))
+    {
+        uint8_t hi = color >> 8, lo = color;
+        if (hi == lo)
+        {
+            memset(_repeat, hi, GFX_SPI_REPEAT_BYTES);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < GFX_SPI_REPEAT_BYTES; i += 2)
+            {
+                _repeat[i] = hi;
+                _repeat[i + 1] = lo;
+            }
+        }
+        _repeatColor = color;
+        _repeatFull = true;
+    }
+    for (; bytes > n; bytes -= n)
+        writeBytes(_repeat, n);
+    writeBytes(_repeat, bytes);
+}
+
+/*!
+    @brief  Start sending a burst of bytes. With asynchronous SPI, returns
+            as soon as the transfer has started (after any previous one
+            has finished); otherwise same as writeBytes(). Every other
+            access to the bus waits for the transfer to end first.
+    @param  buf  Bytes to send, left alone until wait().
+    @param  len  Number of bytes.
+*/
+void GFXspiBus::writeBytesAsync(const uint8_t *buf, uint32_t len)
+{
+#if DEVICE_SPI_ASYNCH
+    wait();
+    _busy = true;
+    if (!_spi->transfer(buf, len, (uint8_t *)NULL, 0, callback(this, &GFXspiBus::transferDone), SPI_EVENT_COMPLETE))
+        return;
+    _busy = false; // Couldn't start, fall back to blocking
+#endif
+    writeBytes(buf, len);
+}
+
+/*!
+    @brief  Wait for the transfer started by writeBytesAsync() to end.
+*/
+void GFXspiBus::wait(void)
+{
+#if DEVICE_SPI_ASYNCH
+    while (_busy)
+        ;
+#endif
+}
+
+/*!
+    @brief   Read a byte (sending a 0).
+    @return  Byte read.
+*/
+uint8_t GFXspiBus::read8(void)
+{
+    wait();
+    return _spi->write((uint8_t)0);
+}
+
+#if DEVICE_SPI_ASYNCH
+/*!
+    @brief  Completion callback for writeBytesAsync() transfers.
+    @param  event  SPI event flags (unused).
+*/
+void GFXspiBus::transferDone(int /*event*/)
+{
+    _busy = false;
+}
+#endif
+
+// SOFTWARE SPI ------------------------------------------------------------
+
+/*!
+    @brief  GFXsoftSpiBus constructor. Pins are set up by begin().
+    @param  cs    Chip select pin (NC if unused, tie CS low).
+    @param  dc    Data/command select pin (required).
+    @param  mosi  MOSI pin (required).
+    @param  sck   SCK pin (required).
+    @param  miso  MISO pin (optional, many displays don't support SPI
+                  read).
+*/
+GFXsoftSpiBus::GFXsoftSpiBus(PinName cs, PinName dc, PinName mosi, PinName sck, PinName miso)
+    : _cs(cs), _dc(dc), _mosi(mosi), _sck(sck), _miso(miso)
+{
+}
+
+/*!
+    @brief  Set up pins.
+*/
+void GFXsoftSpiBus::begin(void)
+{
+    if (_cs.is_connected())
+        pinMode(_cs, OUTPUT);
+    pinMode(_dc, OUTPUT);
+    GFXbus::begin();
+    pinMode(_mosi, OUTPUT);
+    digitalWrite(_mosi, LOW);
+    pinMode(_sck, OUTPUT);
+    digitalWrite(_sck, LOW);
+    if (_miso.is_connected())
+        pinMode(_miso, INPUT);
+}
+
+/*!
+    @brief  Select or deselect the display.
+    @param  active  true to select.
+*/
+void GFXsoftSpiBus::chipSelect(bool active)
+{
+    if (_cs.is_connected())
+        _cs = active ? LOW : HIGH;
+}
+
+/*!
+    @brief  Set the data/command line.
+    @param  data  true for data, false for commands.
+*/
+void GFXsoftSpiBus::dataMode(bool data)
+{
+    _dc = data ? HIGH : LOW;
+}
+
+/*!
+    @brief  Bit-bang one byte out, most significant bit first.
+    @param  b  Byte to send.
+*/
+void GFXsoftSpiBus::write8(uint8_t b)
+{
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+        _mosi = (b & 0x80) ? HIGH : LOW;
+        _sck = HIGH;
+        b <<= 1;
+        _sck = LOW;
+    }
+}
+
+/*!
+    @brief  Bit-bang a 16-bit value out, most significant bit first.
+    @param  w  Value to send.
+*/
+void GFXsoftSpiBus::write16(uint16_t w)
+{
+    for (uint8_t bit = 0; bit < 16; bit++)
+    {
+        _mosi = (w & 0x8000) ? HIGH : LOW;
+        _sck = HIGH;
+        _sck = LOW;
+        w <<= 1;
+    }
+}
+
+/*!
+    @brief  Bit-bang a burst of bytes out.
+    @param  buf  Bytes to send.
+    @param  len  Number of bytes.
+*/
+void GFXsoftSpiBus::writeBytes(const uint8_t *buf, uint32_t len)
+{
+    while (len--)
+        write8(*buf++);
+}
+
+/*!
+    @brief   Bit-bang a byte in, if there's a MISO pin.
+    @return  Byte read (0 without MISO).
+*/
+uint8_t GFXsoftSpiBus::read8(void)
+{
+    uint8_t b = 0;
+    if (_miso.is_connected())
+    {
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            _sck = HIGH;
+            b <<= 1;
+            if (_miso)
+                b++;
+            _sck = LOW;
+        }
+    }
+    return b;
+}
+
+// MOCK --------------------------------------------------------------------
+
+/*!
+    @brief  GFXmockBus constructor.
+    @param  capacity  Bytes to record; anything sent beyond that is
+                      dropped (see overflowed()).
+*/
+GFXmockBus::GFXmockBus(uint32_t capacity)
+    : _capacity(capacity), _length(0), _overflow(false), _data(true), _selected(false)
+{
+    if (!(_log = (uint16_t *)malloc(capacity * sizeof(uint16_t))))
+        _capacity = 0;
+}
+
+/*!
+    @brief  Free the log.
+*/
+GFXmockBus::~GFXmockBus(void)
+{
+    if (_log)
+        free(_log);
+}
+
+/*!
+    @brief  Note the chip select state.
+    @param  active  true if selected.
+*/
+void GFXmockBus::chipSelect(bool active)
+{
+    _selected = active;
+}
+
+/*!
+    @brief  Note whether following bytes are data or commands.
+    @param  data  true for data, false for commands.
+*/
+void GFXmockBus::dataMode(bool data)
+{
+    _data = data;
+}
+
+/*!
+    @brief  Record one byte, flagged with GFX_MOCK_COMMAND if sent as a
+            command.
+    @param  b  Byte sent.
+*/
+void GFXmockBus::write8(uint8_t b)
+{
+    if (_length < _capacity)
+        _log[_length++] = _data ? b : (GFX_MOCK_COMMAND | b);
+    else
+        _overflow = true;
+}
+
+/*!
+    @brief  Record a burst of bytes.
+    @param  buf  Bytes sent.
+    @param  len  Number of bytes.
+*/
+void GFXmockBus::writeBytes(const uint8_t *buf, uint32_t len)
+{
+    while (len--)
+        write8(*buf++);
+}
+
+/*!
+    @brief   Get the bytes recorded since construction or clear().
+    @return  length() entries: a byte, OR'd with GFX_MOCK_COMMAND if sent
+             as a command.
+*/
+const uint16_t *GFXmockBus::log(void) const
+{
+    return _log;
+}
+
+/*!
+    @brief   Get the number of bytes recorded.
+    @return  Entries in log().
+*/
+uint32_t GFXmockBus::length(void) const
+{
+    return _length;
+}
+
+/*!
+    @brief   Check whether bytes were dropped for lack of room.
+    @return  true if anything sent wasn't recorded.
+*/
+bool GFXmockBus::overflowed(void) const
+{
+    return _overflow;
+}
+
+/*!
+    @brief   Check whether the display is selected, e.g. that every
+             startWrite() was matched by endWrite().
+    @return  true if selected.
+*/
+bool GFXmockBus::selected(void) const
+{
+    return _selected;
+}
+
+/*!
+    @brief  Forget everything recorded.
+*/
+void GFXmockBus::clear(void)
+{
+    _length = 0;
+    _overflow = false;
+}
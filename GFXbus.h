@@ -0,0 +1,165 @@
+/*!
+ * @file GFXbus.h
+ *
+ * Part of Adafruit's GFX graphics library. Display buses: the transport
+ * Adafruit_SPITFT uses to reach the display controller. A bus sends
+ * commands, data bytes, bursts of pixels (optionally asynchronously) and
+ * runs of one repeated color; Adafruit_SPITFT makes one call per burst,
+ * so a faster transport (DMA, a parallel port, a display over a network)
+ * or a mock for tests (GFXmockBus) is a matter of implementing this
+ * interface.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXBUS_H_
+#define _GFXBUS_H_
+
+#include "Arduino.h"
+#include <SPI.h>
+
+#define DEFAULT_SPI_FREQ 16000000L ///< Hardware SPI default speed
+#ifndef GFX_BUS_REPEAT_CHUNK
+#define GFX_BUS_REPEAT_CHUNK 128 ///< Pixels staged (on the stack) per burst by writeRepeat()
+#endif
+#ifndef GFX_SPI_REPEAT_BYTES
+#define GFX_SPI_REPEAT_BYTES 1024 ///< Bytes GFXspiBus stages (on the heap) per burst by writeRepeat()
+#endif
+#define GFX_MOCK_COMMAND 0x100 ///< GFXmockBus log flag: byte was sent as a command
+
+/*!
+  @brief  Interface to a display controller. Only chipSelect(), dataMode(),
+          write8() and writeBytes() MUST be implemented; the rest have
+          generic versions built on those, which a bus MAY replace with
+          faster ones.
+*/
+class GFXbus
+{
+public:
+	virtual ~GFXbus(void) {}
+
+	virtual void begin(void);
+	virtual void startWrite(void);
+	virtual void endWrite(void);
+
+	/*!
+	    @brief  Select or deselect the display (chip select line), if the
+	            bus has one.
+	    @param  active  true to select.
+	*/
+	virtual void chipSelect(bool active) = 0;
+	/*!
+	    @brief  Set what following bytes are (data/command line).
+	    @param  data  true for data, false for commands.
+	*/
+	virtual void dataMode(bool data) = 0;
+	/*!
+	    @brief  Send one byte.
+	    @param  b  Byte to send.
+	*/
+	virtual void write8(uint8_t b) = 0;
+	/*!
+	    @brief  Send a burst of bytes, e.g. pixels in display (big-endian)
+	            order.
+	    @param  buf  Bytes to send.
+	    @param  len  Number of bytes.
+	*/
+	virtual void writeBytes(const uint8_t *buf, uint32_t len) = 0;
+
+	virtual void writeCommand(uint8_t cmd);
+	virtual void write16(uint16_t w);
+	virtual void write32(uint32_t l);
+	virtual void writeRepeat(uint16_t color, uint32_t len);
+	virtual void writeBytesAsync(const uint8_t *buf, uint32_t len);
+	virtual void wait(void);
+	virtual uint8_t read8(void);
+};
+
+/*!
+  @brief  Display on an mbed SPI peripheral, with chip select (optional)
+          and data/command lines. Bursts go out as single SPI transfers,
+          asynchronously where the target supports it.
+*/
+class GFXspiBus : public GFXbus
+{
+public:
+	GFXspiBus(SPI &spi, PinName cs, PinName dc, int bits = 8, int mode = 0, uint32_t freq = DEFAULT_SPI_FREQ, bool ownSpi = false);
+	~GFXspiBus(void);
+
+	void begin(void);
+	void chipSelect(bool active);
+	void dataMode(bool data);
+	void write8(uint8_t b);
+	void write16(uint16_t w);
+	void write32(uint32_t l);
+	void writeBytes(const uint8_t *buf, uint32_t len);
+	void writeRepeat(uint16_t color, uint32_t len);
+	void writeBytesAsync(const uint8_t *buf, uint32_t len);
+	void wait(void);
+	uint8_t read8(void);
+
+private:
+#if DEVICE_SPI_ASYNCH
+	void transferDone(int event);
+	volatile bool _busy; ///< Asynchronous transfer in flight
+#endif
+	SPI *_spi;
+	bool _ownSpi; ///< If set, _spi is deleted with the bus
+	DigitalInOut _cs, _dc;
+	int _bits, _mode;
+	uint32_t _freq;
+	uint8_t *_repeat;	  ///< writeRepeat() staging, NULL until begin() (or if out of memory)
+	uint16_t _repeatColor; ///< Color _repeat holds
+	bool _repeatFull;	  ///< If set, _repeat holds _repeatColor throughout
+};
+
+/*!
+  @brief  Display on bit-banged (software) SPI.
+*/
+class GFXsoftSpiBus : public GFXbus
+{
+public:
+	GFXsoftSpiBus(PinName cs, PinName dc, PinName mosi, PinName sck, PinName miso = NC);
+
+	void begin(void);
+	void chipSelect(bool active);
+	void dataMode(bool data);
+	void write8(uint8_t b);
+	void write16(uint16_t w);
+	void writeBytes(const uint8_t *buf, uint32_t len);
+	uint8_t read8(void);
+
+private:
+	DigitalInOut _cs, _dc, _mosi, _sck, _miso;
+};
+
+/*!
+  @brief  Display stand-in for host tests: records everything sent, in
+          order, to compare against what a driver should produce. Each
+          byte is logged as a 16-bit entry, commands flagged with
+          GFX_MOCK_COMMAND; reads return 0.
+*/
+class GFXmockBus : public GFXbus
+{
+public:
+	GFXmockBus(uint32_t capacity);
+	~GFXmockBus(void);
+
+	void chipSelect(bool active);
+	void dataMode(bool data);
+	void write8(uint8_t b);
+	void writeBytes(const uint8_t *buf, uint32_t len);
+
+	const uint16_t *log(void) const;
+	uint32_t length(void) const;
+	bool overflowed(void) const;
+	bool selected(void) const;
+	void clear(void);
+
+private:
+	uint16_t *_log;
+	uint32_t _capacity, _length;
+	bool _overflow, _data, _selected;
+};
+
+#endif // _GFXBUS_H_
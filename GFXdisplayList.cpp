@@ -0,0 +1,661 @@
+/*!
+ * @file GFXdisplayList.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Recorded frames with occlusion
+ * culling.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXdisplayList.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define GFX_DL_FRAGMENTED 0xFF ///< visible(): too many pieces to track
+
+/*!
+    @brief  GFXdisplayList constructor.
+    @param  target    Device the list is replayed on; the list takes its
+                      size at the current rotation.
+    @param  capacity  Commands held; when full, the list is flushed (culled
+                      and replayed) and recording continues in a new list.
+*/
+GFXdisplayList::GFXdisplayList(Adafruit_GFX &target, uint16_t capacity)
+    : Adafruit_GFX(target.width(), target.height()), _target(target), _capacity(capacity ? capacity : 1), _count(0)
+{
+    _cmds = (GFXdlCommand *)malloc(_capacity * sizeof(GFXdlCommand));
+}
+
+/*!
+    @brief  Free the command list. Commands not yet replayed are lost.
+*/
+GFXdisplayList::~GFXdisplayList(void)
+{
+    if (_cmds)
+        free(_cmds);
+}
+
+/*!
+    @brief  Record a single pixel.
+    @param  x      Horizontal position (0 = left).
+    @param  y      Vertical position (0 = top).
+    @param  color  16-bit pixel color in '565' RGB format.
+*/
+void GFXdisplayList::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+        return;
+    GFXdlCommand cmd;
+    cmd.type = GFX_DL_PIXEL;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.w = cmd.h = 1;
+    cmd.color = color;
+    add(cmd);
+}
+
+/*!
+    @brief  Record a single pixel (same as drawPixel()).
+    @param  x      Horizontal position (0 = left).
+    @param  y      Vertical position (0 = top).
+    @param  color  16-bit pixel color in '565' RGB format.
+*/
+void GFXdisplayList::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    drawPixel(x, y, color);
+}
+
+/*!
+    @brief  Record a filled rectangle, clipped to the screen.
+    @param  x      Left edge (or right edge, with negative width).
+    @param  y      Top edge (or bottom edge, with negative height).
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXdisplayList::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (w < 0)
+    {
+        w = -w;
+        x -= w - 1;
+    }
+    if (h < 0)
+    {
+        h = -h;
+        y -= h - 1;
+    }
+    int16_t x0 = max(x, 0), y0 = max(y, 0);
+    int16_t x1 = min(x + w, _width), y1 = min(y + h, _height);
+    if ((x1 <= x0) || (y1 <= y0))
+        return;
+    GFXdlCommand cmd;
+    cmd.type = GFX_DL_FILL;
+    cmd.x = x0;
+    cmd.y = y0;
+    cmd.w = x1 - x0;
+    cmd.h = y1 - y0;
+    cmd.color = color;
+    add(cmd);
+}
+
+/*!
+    @brief  Record a vertical line.
+    @param  x      Column.
+    @param  y      Top end.
+    @param  h      Length in pixels.
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXdisplayList::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    writeFillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Record a horizontal line.
+    @param  x      Left end.
+    @param  y      Row.
+    @param  w      Length in pixels.
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXdisplayList::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    writeFillRect(x, y, w, 1, color);
+}
+
+/*!
+    @brief  Record a vertical line.
+    @param  x      Column.
+    @param  y      Top end.
+    @param  h      Length in pixels.
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXdisplayList::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    writeFillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Record a horizontal line.
+    @param  x      Left end.
+    @param  y      Row.
+    @param  w      Length in pixels.
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXdisplayList::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    writeFillRect(x, y, w, 1, color);
+}
+
+/*!
+    @brief  Record a filled rectangle.
+    @param  x      Left edge.
+    @param  y      Top edge.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXdisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    writeFillRect(x, y, w, h, color);
+}
+
+/*!
+    @brief  Record a fill of the whole screen. Everything recorded before
+            it will be culled.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXdisplayList::fillScreen(uint16_t color)
+{
+    writeFillRect(0, 0, _width, _height, color);
+}
+
+/*!
+    @brief  Record a RAM-resident 16-bit image (referenced, not copied).
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  Pixels, MUST stay unchanged until replayed.
+    @param  w       Width of bitmap in pixels.
+    @param  h       Height of bitmap in pixels.
+*/
+void GFXdisplayList::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h)
+{
+    drawRGBSubBitmap(x, y, bitmap, w, w, h);
+}
+
+/*!
+    @brief  Record a region of a RAM-resident 16-bit image (referenced, not
+            copied), clipped to the screen.
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  First pixel of the region, MUST stay unchanged until
+                    replayed.
+    @param  stride  Bitmap width, in pixels.
+    @param  w       Width of region in pixels.
+    @param  h       Height of region in pixels.
+*/
+void GFXdisplayList::drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h)
+{
+    int16_t x0 = max(x, 0), y0 = max(y, 0);
+    int16_t x1 = min(x + w, _width), y1 = min(y + h, _height);
+    if ((x1 <= x0) || (y1 <= y0))
+        return;
+    GFXdlCommand cmd;
+    cmd.type = GFX_DL_BITMAP;
+    cmd.x = x0;
+    cmd.y = y0;
+    cmd.w = x1 - x0;
+    cmd.h = y1 - y0;
+    cmd.bitmap.pixels = bitmap + (int32_t)(y0 - y) * stride + (x0 - x);
+    cmd.bitmap.stride = stride;
+    add(cmd);
+}
+
+/*!
+    @brief  Record a character of the classic built-in font. With a
+            background color the whole cell is opaque.
+    @param  x       Left edge of character cell.
+    @param  y       Top edge of character cell.
+    @param  c       Index into the built-in font (CP437 setting applied).
+    @param  color   16-bit character color in '565' RGB format.
+    @param  bg      16-bit background color (if same as color, none).
+    @param  size_x  Font magnification level in X-axis.
+    @param  size_y  Font magnification level in Y-axis.
+*/
+void GFXdisplayList::drawClassicChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
+{
+    GFXdlCommand cmd;
+    cmd.type = GFX_DL_CLASSIC;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.color = color;
+    cmd.bg = bg;
+    cmd.size_x = size_x;
+    cmd.size_y = size_y;
+    cmd.c = c;
+    Rect r;
+    if (bounds(cmd, &r))
+        add(cmd);
+}
+
+/*!
+    @brief  Record a character of a custom or streamed font (never opaque,
+            these fonts have no background).
+    @param  x       Cursor position, horizontal.
+    @param  y       Cursor position, vertical (baseline).
+    @param  glyph   Glyph metrics (copied).
+    @param  bitmap  Glyph bitmap, MUST stay unchanged until replayed.
+    @param  color   16-bit character color in '565' RGB format.
+    @param  size_x  Font magnification level in X-axis.
+    @param  size_y  Font magnification level in Y-axis.
+*/
+void GFXdisplayList::drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint16_t color, uint8_t size_x, uint8_t size_y)
+{
+    GFXdlCommand cmd;
+    cmd.type = GFX_DL_GLYPH;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.color = color;
+    cmd.size_x = size_x;
+    cmd.size_y = size_y;
+    cmd.glyph.metrics = *glyph;
+    cmd.glyph.pixels = bitmap;
+    Rect r;
+    if (bounds(cmd, &r))
+        add(cmd);
+}
+
+/*!
+    @brief   Remove what won't be seen. Working from the last command back,
+             each command is compared with the opaque areas drawn after it:
+             if they hide it completely it's dropped, and a fill or bitmap
+             they hide partly is replaced by its visible parts (unless it
+             would take more than GFX_DL_PIECES of them). Painter's order
+             is kept, so replay() draws the same image.
+    @return  Number of pixels no longer drawn.
+*/
+uint32_t GFXdisplayList::cull(void)
+{
+    if (!_cmds)
+        return 0;
+
+    Rect occluders[GFX_DL_OCCLUDERS];
+    uint32_t areas[GFX_DL_OCCLUDERS];
+    uint8_t nOccluders = 0;
+    uint32_t saved = 0;
+
+    // Survivors are written backward from the end of the list. Command r
+    // is copied out before its slot can be overwritten, and when a command
+    // can't be split for lack of room it is kept whole, so the write
+    // position never passes the read position.
+    uint16_t out = _capacity;
+    for (uint16_t r = _count; r--;)
+    {
+        GFXdlCommand cmd = _cmds[r];
+        Rect b, pieces[GFX_DL_PIECES];
+        if (!bounds(cmd, &b))
+            continue; // Offscreen text
+        uint32_t area = (uint32_t)(b.x1 - b.x0 + 1) * (b.y1 - b.y0 + 1);
+
+        uint8_t n = visible(b, occluders, nOccluders, pieces);
+        if (!n)
+        {
+            saved += area; // Hidden
+        }
+        else if ((n == GFX_DL_FRAGMENTED) || ((n == 1) && !memcmp(&pieces[0], &b, sizeof(b))) ||
+                 ((cmd.type != GFX_DL_FILL) && (cmd.type != GFX_DL_BITMAP)) || (out - n < r))
+        {
+            _cmds[--out] = cmd; // Kept whole
+        }
+        else
+        {
+            for (uint8_t i = 0; i < n; i++)
+            {
+                GFXdlCommand &p = _cmds[--out];
+                p = cmd;
+                p.x = pieces[i].x0;
+                p.y = pieces[i].y0;
+                p.w = pieces[i].x1 - pieces[i].x0 + 1;
+                p.h = pieces[i].y1 - pieces[i].y0 + 1;
+                if (cmd.type == GFX_DL_BITMAP)
+                    p.bitmap.pixels += (int32_t)(p.y - cmd.y) * cmd.bitmap.stride + (p.x - cmd.x);
+                area -= (uint32_t)p.w * p.h;
+            }
+            saved += area;
+        }
+
+        // Opaque commands hide what came before. The largest areas are
+        // kept, largest first: tested in that order, small occluders
+        // (e.g. text cells) rarely split what the large ones leave.
+        bool opaque = (cmd.type == GFX_DL_FILL) || (cmd.type == GFX_DL_PIXEL) || (cmd.type == GFX_DL_BITMAP) ||
+                      ((cmd.type == GFX_DL_CLASSIC) && (cmd.bg != cmd.color));
+        if (opaque)
+        {
+            area = (uint32_t)(b.x1 - b.x0 + 1) * (b.y1 - b.y0 + 1);
+            uint8_t i = nOccluders;
+            if (nOccluders < GFX_DL_OCCLUDERS)
+                nOccluders++;
+            else if (areas[--i] >= area)
+                continue; // Smaller than all those kept
+            for (; i && (areas[i - 1] < area); i--)
+            {
+                occluders[i] = occluders[i - 1];
+                areas[i] = areas[i - 1];
+            }
+            occluders[i] = b;
+            areas[i] = area;
+        }
+    }
+
+    _count = _capacity - out;
+    memmove(_cmds, _cmds + out, _count * sizeof(GFXdlCommand));
+    return saved;
+}
+
+/*!
+    @brief   Reorder and merge commands to need fewer address windows and
+             transactions, without changing the image. A fill or pixel is
+             moved up past commands it doesn't overlap to merge with an
+             earlier fill of the same color when the two make a rectangle
+             (e.g. the cells of a bar or grid row, then the rows), and
+             fills are moved up to join the fills before them so replay()
+             sends them in one transaction. Commands that overlap keep
+             their order.
+    @return  Number of address windows saved (commands merged away).
+*/
+uint16_t GFXdisplayList::batch(void)
+{
+    if (!_cmds)
+        return 0;
+
+    uint16_t saved = 0;
+    bool merged = true;
+    while (merged)
+    { // Merged fills may merge again, e.g. rows into a block
+        merged = false;
+        for (uint16_t i = 1; i < _count; i++)
+        {
+            if (mergeFill(i))
+            {
+                saved++;
+                merged = true;
+                i--;
+            }
+        }
+    }
+
+    // Group fills into runs: move each up to just after the nearest fill
+    // before it, if it overlaps nothing it would move past
+    for (uint16_t i = 1; i < _count; i++)
+    {
+        uint8_t t = _cmds[i].type;
+        if (((t != GFX_DL_FILL) && (t != GFX_DL_PIXEL)) || (_cmds[i - 1].type == GFX_DL_FILL) || (_cmds[i - 1].type == GFX_DL_PIXEL))
+            continue;
+        Rect r, o;
+        bounds(_cmds[i], &r);
+        for (uint16_t j = i; j--;)
+        {
+            t = _cmds[j].type;
+            if ((t == GFX_DL_FILL) || (t == GFX_DL_PIXEL))
+            {
+                moveCommand(i, j + 1);
+                break;
+            }
+            if (bounds(_cmds[j], &o) && (o.x0 <= r.x1) && (o.x1 >= r.x0) && (o.y0 <= r.y1) && (o.y1 >= r.y0))
+                break; // Must stay after this one
+        }
+    }
+    return saved;
+}
+
+/*!
+    @brief  Draw the recorded commands on the target device, in order. Runs
+            of fills and pixels share one transaction. The list is kept
+            (see clear()).
+*/
+void GFXdisplayList::replay(void)
+{
+    for (uint16_t i = 0; i < _count;)
+    {
+        uint8_t t = _cmds[i].type;
+        if ((t != GFX_DL_FILL) && (t != GFX_DL_PIXEL))
+        {
+            draw(_cmds[i++]);
+            continue;
+        }
+        _target.startWrite();
+        for (; (i < _count) && ((t = _cmds[i].type) == GFX_DL_FILL || (t == GFX_DL_PIXEL)); i++)
+        {
+            const GFXdlCommand &cmd = _cmds[i];
+            if (t == GFX_DL_PIXEL)
+                _target.writePixel(cmd.x, cmd.y, cmd.color);
+            else
+                _target.writeFillRect(cmd.x, cmd.y, cmd.w, cmd.h, cmd.color);
+        }
+        _target.endWrite();
+    }
+}
+
+/*!
+    @brief  Empty the list, ready to record the next frame.
+*/
+void GFXdisplayList::clear(void)
+{
+    _count = 0;
+}
+
+/*!
+    @brief   Cull, batch (optionally), replay and clear: draw the recorded
+             frame.
+    @param   batching  If true, batch() before replaying.
+    @return  Number of pixels culled.
+*/
+uint32_t GFXdisplayList::flush(bool batching)
+{
+    uint32_t saved = cull();
+    if (batching)
+        batch();
+    replay();
+    clear();
+    return saved;
+}
+
+/*!
+    @brief   Get the number of commands in the list.
+    @return  Command count.
+*/
+uint16_t GFXdisplayList::size(void) const
+{
+    return _count;
+}
+
+/*!
+    @brief   Get the recorded commands, e.g. for inspection or further
+             processing.
+    @return  size() commands, in drawing order.
+*/
+const GFXdlCommand *GFXdisplayList::commands(void) const
+{
+    return _cmds;
+}
+
+/*!
+    @brief  Append a command, flushing first if the list is full. Without a
+            list (allocation failed) the command is drawn immediately.
+    @param  cmd  Command to record.
+*/
+void GFXdisplayList::add(const GFXdlCommand &cmd)
+{
+    if (!_cmds)
+    {
+        draw(cmd);
+        return;
+    }
+    if (_count == _capacity)
+        flush();
+    _cmds[_count++] = cmd;
+}
+
+/*!
+    @brief  Draw one command on the target device.
+    @param  cmd  Command to draw.
+*/
+void GFXdisplayList::draw(const GFXdlCommand &cmd)
+{
+    switch (cmd.type)
+    {
+    case GFX_DL_FILL:
+        _target.fillRect(cmd.x, cmd.y, cmd.w, cmd.h, cmd.color);
+        break;
+    case GFX_DL_PIXEL:
+        _target.drawPixel(cmd.x, cmd.y, cmd.color);
+        break;
+    case GFX_DL_BITMAP:
+        _target.drawRGBSubBitmap(cmd.x, cmd.y, cmd.bitmap.pixels, cmd.bitmap.stride, cmd.w, cmd.h);
+        break;
+    case GFX_DL_CLASSIC:
+        _target.drawClassicChar(cmd.x, cmd.y, cmd.c, cmd.color, cmd.bg, cmd.size_x, cmd.size_y);
+        break;
+    case GFX_DL_GLYPH:
+        _target.drawGlyph(cmd.x, cmd.y, &cmd.glyph.metrics, cmd.glyph.pixels, cmd.color, cmd.size_x, cmd.size_y);
+        break;
+    }
+}
+
+/*!
+    @brief   Get the onscreen area a command draws in (or may, for text).
+    @param   cmd  Command.
+    @param   r    Set to the area, clipped to the screen.
+    @return  false if nothing is onscreen.
+*/
+bool GFXdisplayList::bounds(const GFXdlCommand &cmd, Rect *r) const
+{
+    int16_t x = cmd.x, y = cmd.y, w = cmd.w, h = cmd.h;
+    if (cmd.type == GFX_DL_CLASSIC)
+    {
+        w = 6 * cmd.size_x;
+        h = 8 * cmd.size_y;
+    }
+    else if (cmd.type == GFX_DL_GLYPH)
+    {
+        x += cmd.glyph.metrics.xOffset * cmd.size_x;
+        y += cmd.glyph.metrics.yOffset * cmd.size_y;
+        w = cmd.glyph.metrics.width * cmd.size_x;
+        h = cmd.glyph.metrics.height * cmd.size_y;
+    }
+    r->x0 = max(x, 0);
+    r->y0 = max(y, 0);
+    r->x1 = min(x + w, _width) - 1;
+    r->y1 = min(y + h, _height) - 1;
+    return (r->x0 <= r->x1) && (r->y0 <= r->y1);
+}
+
+/*!
+    @brief   Try to merge a fill or pixel into an earlier fill of the same
+             color, moving it up past the commands in between (which it
+             MUST NOT overlap). The two must make a rectangle: same rows
+             and touching or overlapping columns, or the reverse, or one
+             containing the other.
+    @param   i  Index of the command to merge.
+    @return  true if merged (command i is then removed).
+*/
+bool GFXdisplayList::mergeFill(uint16_t i)
+{
+    const GFXdlCommand &cmd = _cmds[i];
+    if ((cmd.type != GFX_DL_FILL) && (cmd.type != GFX_DL_PIXEL))
+        return false;
+    Rect r, o;
+    bounds(cmd, &r);
+    for (uint16_t j = i; j--;)
+    {
+        GFXdlCommand &prev = _cmds[j];
+        if (!bounds(prev, &o))
+            continue; // Draws nothing
+        if (((prev.type == GFX_DL_FILL) || (prev.type == GFX_DL_PIXEL)) && (prev.color == cmd.color))
+        {
+            bool rows = (o.y0 == r.y0) && (o.y1 == r.y1) && (o.x0 <= r.x1 + 1) && (r.x0 <= o.x1 + 1);
+            bool cols = (o.x0 == r.x0) && (o.x1 == r.x1) && (o.y0 <= r.y1 + 1) && (r.y0 <= o.y1 + 1);
+            bool inside = ((o.x0 <= r.x0) && (o.x1 >= r.x1) && (o.y0 <= r.y0) && (o.y1 >= r.y1)) ||
+                          ((r.x0 <= o.x0) && (r.x1 >= o.x1) && (r.y0 <= o.y0) && (r.y1 >= o.y1));
+            if (rows || cols || inside)
+            {
+                prev.type = GFX_DL_FILL;
+                prev.x = min(o.x0, r.x0);
+                prev.y = min(o.y0, r.y0);
+                prev.w = max(o.x1, r.x1) - prev.x + 1;
+                prev.h = max(o.y1, r.y1) - prev.y + 1;
+                memmove(&_cmds[i], &_cmds[i + 1], (_count - i - 1) * sizeof(GFXdlCommand));
+                _count--;
+                return true;
+            }
+        }
+        if ((o.x0 <= r.x1) && (o.x1 >= r.x0) && (o.y0 <= r.y1) && (o.y1 >= r.y0))
+            return false; // Must stay after this one
+    }
+    return false;
+}
+
+/*!
+    @brief  Move a command earlier in the list.
+    @param  from  Index of the command.
+    @param  to    New index (at most from).
+*/
+void GFXdisplayList::moveCommand(uint16_t from, uint16_t to)
+{
+    GFXdlCommand cmd = _cmds[from];
+    memmove(&_cmds[to + 1], &_cmds[to], (from - to) * sizeof(GFXdlCommand));
+    _cmds[to] = cmd;
+}
+
+/*!
+    @brief   Find the parts of a rectangle not hidden by a set of others.
+    @param   r          Rectangle.
+    @param   occluders  Hiding rectangles.
+    @param   count      Number of hiding rectangles.
+    @param   pieces     Set to the visible parts (GFX_DL_PIECES entries,
+                        disjoint, in no particular order).
+    @return  Number of visible parts (0 if hidden), or GFX_DL_FRAGMENTED if
+             there would be more than GFX_DL_PIECES.
+*/
+uint8_t GFXdisplayList::visible(const Rect &r, const Rect *occluders, uint8_t count, Rect *pieces) const
+{
+    uint8_t n = 1;
+    pieces[0] = r;
+    for (uint8_t o = 0; (o < count) && n; o++)
+    {
+        const Rect &h = occluders[o];
+        for (uint8_t i = 0; i < n;)
+        {
+            Rect p = pieces[i];
+            if ((p.x1 < h.x0) || (p.x0 > h.x1) || (p.y1 < h.y0) || (p.y0 > h.y1))
+            {
+                i++; // No overlap
+                continue;
+            }
+            // Replace the piece by what's left of it: the bands above and
+            // below the occluder, and either side of it in between.
+            Rect parts[4];
+            uint8_t k = 0;
+            int16_t y0 = max(p.y0, h.y0), y1 = min(p.y1, h.y1);
+            if (p.y0 < h.y0)
+                parts[k++] = {p.x0, p.y0, p.x1, (int16_t)(h.y0 - 1)};
+            if (p.y1 > h.y1)
+                parts[k++] = {p.x0, (int16_t)(h.y1 + 1), p.x1, p.y1};
+            if (p.x0 < h.x0)
+                parts[k++] = {p.x0, y0, (int16_t)(h.x0 - 1), y1};
+            if (p.x1 > h.x1)
+                parts[k++] = {(int16_t)(h.x1 + 1), y0, p.x1, y1};
+            if (n - 1 + k > GFX_DL_PIECES)
+                return GFX_DL_FRAGMENTED;
+            pieces[i] = pieces[--n]; // Not yet tested against this occluder
+            for (uint8_t j = 0; j < k; j++)
+                pieces[n++] = parts[j]; // Clear of this occluder
+        }
+    }
+    return n;
+}
@@ -0,0 +1,114 @@
+/*!
+ * @file GFXdisplayList.h
+ *
+ * Part of Adafruit's GFX graphics library. Recorded frames: drawing on a
+ * GFXdisplayList is kept as a list of commands (fills, pixels, bitmaps,
+ * characters) instead of being sent to the display. Before the list is
+ * replayed, cull() uses the opaque commands (fills, bitmaps, pixels,
+ * classic-font text with a background) to drop anything they completely
+ * cover and to trim partly covered fills and bitmaps down to their
+ * visible parts, so a screen drawn as background, then panels, then
+ * widgets sends each pixel about once rather than once per layer. batch()
+ * then merges same-color fills and groups fills together where that
+ * doesn't change what overlaps what, saving address windows and
+ * transactions.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXDISPLAYLIST_H_
+#define _GFXDISPLAYLIST_H_
+
+#include "Adafruit_GFX.h"
+
+#define GFX_DL_OCCLUDERS 24 ///< Opaque areas cull() tests against (largest kept)
+#define GFX_DL_PIECES 8		///< Visible parts a trimmed command may split into
+
+// Possible values for GFXdlCommand.type:
+#define GFX_DL_FILL 0	///< Solid rectangle
+#define GFX_DL_PIXEL 1   ///< Single pixel
+#define GFX_DL_BITMAP 2  ///< Region of a RAM-resident 16-bit bitmap
+#define GFX_DL_CLASSIC 3 ///< Character of the classic built-in font
+#define GFX_DL_GLYPH 4   ///< Character of a custom or streamed font
+
+/// One recorded drawing command
+typedef struct
+{
+	uint8_t type;			///< GFX_DL_FILL, GFX_DL_PIXEL, etc.
+	uint8_t size_x, size_y; ///< Text magnification
+	int16_t x, y;			///< Top left corner (text: as passed to drawChar())
+	int16_t w, h;			///< Size, clipped to the screen (not used for text)
+	uint16_t color;			///< Fill, pixel or text color
+	uint16_t bg;			///< Classic font background (same as color: none)
+	union {
+		struct
+		{
+			uint16_t *pixels; ///< Pixel drawn at (x, y)
+			int16_t stride;   ///< Bitmap width, in pixels
+		} bitmap;			  ///< GFX_DL_BITMAP source
+		unsigned char c;	  ///< GFX_DL_CLASSIC character (CP437 applied)
+		struct
+		{
+			GFXglyph metrics;	  ///< Glyph size and offsets
+			const uint8_t *pixels; ///< Glyph bitmap
+		} glyph;				   ///< GFX_DL_GLYPH source
+	};
+} GFXdlCommand;
+
+/*!
+  @brief  Adafruit_GFX device recording drawing for later (culled) replay
+          on another device, at that device's current rotation. Bitmaps
+          and glyph bitmaps are referenced, not copied, and MUST stay
+          unchanged until replayed; so glyphs of streamed fonts are only
+          safe if the font's cache holds the whole string.
+*/
+class GFXdisplayList : public Adafruit_GFX
+{
+public:
+	GFXdisplayList(Adafruit_GFX &target, uint16_t capacity = 256);
+	~GFXdisplayList(void);
+
+	void drawPixel(int16_t x, int16_t y, uint16_t color);
+	void writePixel(int16_t x, int16_t y, uint16_t color);
+	void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillScreen(uint16_t color);
+	using Adafruit_GFX::drawRGBBitmap; // Check base class first
+	void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h);
+	void drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h);
+	void drawClassicChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+	void drawGlyph(int16_t x, int16_t y, const GFXglyph *glyph, const uint8_t *bitmap, uint16_t color, uint8_t size_x, uint8_t size_y);
+
+	uint32_t cull(void);
+	uint16_t batch(void);
+	void replay(void);
+	void clear(void);
+	uint32_t flush(bool batching = true);
+
+	uint16_t size(void) const;
+	const GFXdlCommand *commands(void) const;
+
+private:
+	/// Rectangle, inclusive bounds
+	struct Rect
+	{
+		int16_t x0, y0, x1, y1;
+	};
+
+	void add(const GFXdlCommand &cmd);
+	void draw(const GFXdlCommand &cmd);
+	bool bounds(const GFXdlCommand &cmd, Rect *r) const;
+	bool mergeFill(uint16_t i);
+	void moveCommand(uint16_t from, uint16_t to);
+	uint8_t visible(const Rect &r, const Rect *occluders, uint8_t count, Rect *pieces) const;
+
+	Adafruit_GFX &_target;
+	GFXdlCommand *_cmds; ///< capacity entries, first _count in use
+	uint16_t _capacity, _count;
+};
+
+#endif // _GFXDISPLAYLIST_H_
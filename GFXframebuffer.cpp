@@ -0,0 +1,387 @@
+/*!
+ * @file GFXframebuffer.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Linear framebuffer display.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXframebuffer.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <linux/fb.h>
+#include <sys/ioctl.h>
+#endif
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief  GFXframebuffer constructor.
+    @param  layout  Framebuffer geometry and pixel format.
+    @param  pixels  Framebuffer memory (stride * height bytes), or NULL to
+                    map it with begin(). Not freed by the display.
+*/
+GFXframebuffer::GFXframebuffer(const GFXfbLayout &layout, void *pixels)
+    : Adafruit_GFX(layout.width, layout.height), _pixels((uint8_t *)pixels),
+      _bpp(layout.bpp), _stride(layout.stride), _mapped(false)
+{
+    clearDamage();
+}
+
+/*!
+    @brief  Unmap the framebuffer, if mapped by begin().
+*/
+GFXframebuffer::~GFXframebuffer(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (_mapped)
+        munmap(_pixels, (size_t)_stride * HEIGHT);
+#endif
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/*!
+    @brief   Map a framebuffer device, or a regular file in the same layout
+             (grown to stride * height bytes if shorter).
+    @param   path  Device or file path.
+    @return  true on success.
+*/
+bool GFXframebuffer::begin(const char *path)
+{
+    size_t size = (size_t)_stride * HEIGHT;
+    int fd = open(path, O_RDWR);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (!fstat(fd, &st) && S_ISREG(st.st_mode) && ((size_t)st.st_size < size) && ftruncate(fd, size))
+    {
+        close(fd);
+        return false;
+    }
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the device open
+    if (p == MAP_FAILED)
+        return false;
+
+    if (_mapped)
+        munmap(_pixels, size);
+    _pixels = (uint8_t *)p;
+    _mapped = true;
+    return true;
+}
+#endif
+
+#if defined(__linux__)
+/*!
+    @brief   Read the geometry of a Linux framebuffer device, to construct
+             a GFXframebuffer for it.
+    @param   path    Device path, e.g. "/dev/fb0".
+    @param   layout  Visible size, depth and stride, set by function.
+    @return  true on success, false if the device couldn't be queried or
+             isn't 16 or 32 bits per pixel.
+*/
+bool GFXframebuffer::queryDevice(const char *path, GFXfbLayout *layout)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct fb_var_screeninfo var;
+    struct fb_fix_screeninfo fix;
+    bool ok = !ioctl(fd, FBIOGET_VSCREENINFO, &var) && !ioctl(fd, FBIOGET_FSCREENINFO, &fix) &&
+              ((var.bits_per_pixel == 16) || (var.bits_per_pixel == 32));
+    close(fd);
+    if (ok)
+    {
+        layout->width = var.xres;
+        layout->height = var.yres;
+        layout->bpp = var.bits_per_pixel;
+        layout->stride = fix.line_length;
+    }
+    return ok;
+}
+#endif
+
+/*!
+    @brief  Draw a pixel.
+    @param  x      Horizontal position (0 = left).
+    @param  y      Vertical position   (0 = top).
+    @param  color  16-bit 5-6-5 pixel color.
+*/
+void GFXframebuffer::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    int16_t w = 1, h = 1;
+    if (clip(&x, &y, &w, &h))
+        fill(x, y, 1, 1, color);
+}
+
+/*!
+    @brief  Draw a filled rectangle. Same as fillRect(), a framebuffer has
+            no transactions.
+    @param  x      Top left corner horizontal coordinate.
+    @param  y      Top left corner vertical coordinate.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXframebuffer::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    fillRect(x, y, w, h, color);
+}
+
+/*!
+    @brief  Draw a vertical line.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  h      Line height in pixels (positive = below first point,
+                   negative = above first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXframebuffer::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Draw a horizontal line.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  w      Line width in pixels (positive = right of first point,
+                   negative = left of first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXframebuffer::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+/*!
+    @brief  Draw a vertical line.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  h      Line height in pixels (positive = below first point,
+                   negative = above first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXframebuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Draw a horizontal line.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  w      Line width in pixels (positive = right of first point,
+                   negative = left of first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXframebuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+/*!
+    @brief  Draw a filled rectangle, a row at a time.
+    @param  x      Top left corner horizontal coordinate.
+    @param  y      Top left corner vertical coordinate.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXframebuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (clip(&x, &y, &w, &h))
+        fill(x, y, w, h, color);
+}
+
+/*!
+    @brief  Fill the whole framebuffer.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXframebuffer::fillScreen(uint16_t color)
+{
+    if (_pixels)
+        fill(0, 0, WIDTH, HEIGHT, color);
+}
+
+/*!
+    @brief  Draw a RAM-resident 16-bit image (RGB 5/6/5).
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  Array of 16-bit 5-6-5 colors.
+    @param  w       Width of bitmap in pixels.
+    @param  h       Height of bitmap in pixels.
+*/
+void GFXframebuffer::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h)
+{
+    drawRGBSubBitmap(x, y, bitmap, w, w, h);
+}
+
+/*!
+    @brief  Draw a rectangular region of a larger 16-bit image. At rotation
+            0 rows are copied (or converted, at 32 bits per pixel) whole;
+            otherwise the image is drawn pixel by pixel.
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  Pointer to the region's top left pixel.
+    @param  stride  Distance between rows of the image, in pixels.
+    @param  w       Width of region in pixels.
+    @param  h       Height of region in pixels.
+*/
+void GFXframebuffer::drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h)
+{
+    if (rotation)
+    {
+        Adafruit_GFX::drawRGBSubBitmap(x, y, bitmap, stride, w, h);
+        return;
+    }
+
+    int16_t cx = x, cy = y;
+    if ((w <= 0) || (h <= 0) || !clip(&cx, &cy, &w, &h))
+        return;
+    bitmap += (cy - y) * stride + (cx - x);
+    damage(cx, cy, w, h);
+
+    uint8_t *row = _pixels + (uint32_t)cy * _stride;
+    for (int16_t j = 0; j < h; j++, row += _stride, bitmap += stride)
+    {
+        if (_bpp == 16)
+        {
+            memcpy((uint16_t *)row + cx, bitmap, w * 2);
+        }
+        else
+        {
+            uint32_t *p = (uint32_t *)row + cx;
+            for (int16_t i = 0; i < w; i++)
+                p[i] = to32(bitmap[i]);
+        }
+    }
+}
+
+/*!
+    @brief   Get a pointer to the framebuffer memory.
+    @return  First byte of the top row, or NULL if not mapped.
+*/
+uint8_t *GFXframebuffer::getBuffer(void)
+{
+    return _pixels;
+}
+
+/*!
+    @brief   Get the area drawn since the last clearDamage(), as one
+             rectangle in framebuffer (unrotated) coordinates.
+    @param   x  Left edge, set by function.
+    @param   y  Top edge, set by function.
+    @param   w  Width, set by function.
+    @param   h  Height, set by function.
+    @return  false if nothing has been drawn.
+*/
+bool GFXframebuffer::getDamage(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const
+{
+    if (_dx1 < _dx0)
+        return false;
+    *x = _dx0;
+    *y = _dy0;
+    *w = _dx1 - _dx0 + 1;
+    *h = _dy1 - _dy0 + 1;
+    return true;
+}
+
+/*!
+    @brief  Forget the damaged area, e.g. after pushing it to a display.
+*/
+void GFXframebuffer::clearDamage(void)
+{
+    _dx0 = _dy0 = 0x7FFF;
+    _dx1 = _dy1 = -1;
+}
+
+/*!
+    @brief   Convert a rectangle at the current rotation to framebuffer
+             coordinates and clip it to the framebuffer.
+    @param   x  Left edge, converted in place.
+    @param   y  Top edge, converted in place.
+    @param   w  Width, converted in place.
+    @param   h  Height, converted in place.
+    @return  false if nothing is left (or there's no framebuffer).
+*/
+bool GFXframebuffer::clip(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const
+{
+    if (!_pixels || !rotateRect(x, y, w, h))
+        return false;
+    int16_t x1 = min(*x + *w, WIDTH), y1 = min(*y + *h, HEIGHT);
+    *x = max(*x, 0);
+    *y = max(*y, 0);
+    *w = x1 - *x;
+    *h = y1 - *y;
+    return (*w > 0) && (*h > 0);
+}
+
+/*!
+    @brief  Fill a clipped rectangle, framebuffer coordinates.
+    @param  x      Left edge.
+    @param  y      Top edge.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXframebuffer::fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    damage(x, y, w, h);
+    uint8_t *row = _pixels + (uint32_t)y * _stride;
+    if (_bpp == 16)
+    {
+        uint8_t hi = color >> 8, lo = color & 0xFF;
+        for (; h--; row += _stride)
+        {
+            uint16_t *p = (uint16_t *)row + x;
+            if (hi == lo)
+            {
+                memset(p, lo, w * 2);
+            }
+            else
+            {
+                for (int16_t i = 0; i < w; i++)
+                    p[i] = color;
+            }
+        }
+    }
+    else
+    {
+        uint32_t c = to32(color);
+        for (; h--; row += _stride)
+        {
+            uint32_t *p = (uint32_t *)row + x;
+            for (int16_t i = 0; i < w; i++)
+                p[i] = c;
+        }
+    }
+}
+
+/*!
+    @brief  Grow the damaged area to include a rectangle.
+    @param  x  Left edge, framebuffer coordinates.
+    @param  y  Top edge.
+    @param  w  Width in pixels.
+    @param  h  Height in pixels.
+*/
+void GFXframebuffer::damage(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    _dx0 = min(_dx0, x);
+    _dy0 = min(_dy0, y);
+    _dx1 = max(_dx1, x + w - 1);
+    _dy1 = max(_dy1, y + h - 1);
+}
@@ -0,0 +1,85 @@
+/*!
+ * @file GFXframebuffer.h
+ *
+ * Part of Adafruit's GFX graphics library. A display drawing straight into
+ * a linear framebuffer of 16 (RGB565) or 32 (XRGB8888) bits per pixel with
+ * any row stride: a Linux framebuffer device (/dev/fbN), a regular file in
+ * the same layout (for tests), or memory such as an LCD controller's frame
+ * buffer on an MCU. Rectangles, lines and bitmaps are written a row at a
+ * time, and the area changed since the last clearDamage() is tracked so a
+ * caller pushing the framebuffer elsewhere only sends what changed.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXFRAMEBUFFER_H_
+#define _GFXFRAMEBUFFER_H_
+
+#include "Adafruit_GFX.h"
+
+/// Framebuffer geometry and pixel format
+typedef struct
+{
+	int16_t width;	///< Visible width in pixels
+	int16_t height;   ///< Visible height in pixels
+	uint8_t bpp;	  ///< Bits per pixel, 16 or 32
+	uint32_t stride;  ///< Bytes from one row to the next
+} GFXfbLayout;
+
+/*!
+  @brief  Adafruit_GFX device for a memory-mapped framebuffer. Pixels are
+          either supplied to the constructor or mapped by begin().
+*/
+class GFXframebuffer : public Adafruit_GFX
+{
+public:
+	GFXframebuffer(const GFXfbLayout &layout, void *pixels = NULL);
+	~GFXframebuffer(void);
+
+#if defined(__unix__) || defined(__APPLE__)
+	bool begin(const char *path);
+#endif
+#if defined(__linux__)
+	static bool queryDevice(const char *path, GFXfbLayout *layout);
+#endif
+
+	void drawPixel(int16_t x, int16_t y, uint16_t color);
+	void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillScreen(uint16_t color);
+	using Adafruit_GFX::drawRGBBitmap; // Check base class first
+	void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h);
+	void drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h);
+
+	uint8_t *getBuffer(void);
+	bool getDamage(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const;
+	void clearDamage(void);
+
+private:
+	bool clip(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const;
+	void fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void damage(int16_t x, int16_t y, int16_t w, int16_t h);
+	/*!
+	    @brief   Expand a 565 color to the framebuffer's 32-bit format.
+	    @param   c  16-bit 5-6-5 color.
+	    @return  XRGB8888 color.
+	*/
+	static uint32_t to32(uint16_t c)
+	{
+		uint32_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+		return ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+	}
+
+	uint8_t *_pixels;
+	uint8_t _bpp;
+	uint32_t _stride;
+	bool _mapped;		///< If set, _pixels was mapped by begin()
+	int16_t _dx0, _dy0; ///< Damaged area, inclusive, framebuffer coordinates
+	int16_t _dx1, _dy1; ///< (empty if _dx1 < _dx0)
+};
+
+#endif // _GFXFRAMEBUFFER_H_
@@ -0,0 +1,76 @@
+/*!
+ * @file GFXimage.cpp
+ *
+ * Part of Adafruit's GFX graphics library. 16-bit images streamed from
+ * GFXstorage.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXimage.h"
+
+/*!
+    @brief  GFXimage constructor. No storage is accessed until begin() is
+            called.
+    @param  storage  Storage holding the image.
+    @param  addr     Byte address of the image header in storage (several
+                     images may share one storage).
+*/
+GFXimage::GFXimage(GFXstorage &storage, uint32_t addr)
+    : _storage(storage), _addr(addr), _width(0), _height(0)
+{
+}
+
+/*!
+    @brief   Read and check the image header.
+    @return  true on success, false if the header couldn't be read or isn't
+             a stored image.
+*/
+bool GFXimage::begin(void)
+{
+    uint8_t hdr[GFX_IMAGE_HEADER_SIZE];
+    _width = _height = 0;
+    if (_storage.read(hdr, _addr, sizeof(hdr)) || memcmp(hdr, "GFXI", 4))
+        return false;
+
+    int16_t w = hdr[4] | (hdr[5] << 8), h = hdr[6] | (hdr[7] << 8);
+    if ((w <= 0) || (h <= 0))
+        return false;
+    _width = w;
+    _height = h;
+    return true;
+}
+
+/*!
+    @brief   Read consecutive pixels. Rows are stored back to back, so a run
+             may continue onto following rows (e.g. a full-width band).
+    @param   buffer  Destination for len 16-bit pixels, in display
+                     (big-endian) byte order.
+    @param   x       Column of the first pixel.
+    @param   y       Row of the first pixel.
+    @param   len     Number of pixels.
+    @return  0 on success, negative storage error code on failure.
+*/
+int GFXimage::read(void *buffer, int16_t x, int16_t y, uint32_t len)
+{
+    uint32_t pixel = (uint32_t)y * _width + x;
+    return _storage.read(buffer, _addr + GFX_IMAGE_HEADER_SIZE + 2 * pixel, 2 * len);
+}
+
+/*!
+    @brief   Get the image width.
+    @return  Width in pixels, 0 before a successful begin().
+*/
+int16_t GFXimage::width(void) const
+{
+    return _width;
+}
+
+/*!
+    @brief   Get the image height.
+    @return  Height in pixels, 0 before a successful begin().
+*/
+int16_t GFXimage::height(void) const
+{
+    return _height;
+}
@@ -0,0 +1,51 @@
+/*!
+ * @file GFXimage.h
+ *
+ * Part of Adafruit's GFX graphics library. Stored images: 16-bit (565 RGB)
+ * images such as splash screens and sprite sheets kept in a GFXstorage
+ * (external flash, a file) and streamed to the display in chunks, rather
+ * than copied wholesale into RAM. Any rectangular region of an image can
+ * be read directly, so a sprite sheet is simply a large image.
+ *
+ * Stored image layout (header values little-endian):
+ *
+ *   offset 0   'G','F','X','I'  magic
+ *          4   uint16_t width
+ *          6   uint16_t height
+ *          8   width * height pixels, rows top to bottom, each pixel a
+ *              16-bit 565 color stored big-endian (display byte order), so
+ *              pixel data can go to the display as read
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXIMAGE_H_
+#define _GFXIMAGE_H_
+
+#include "Arduino.h"
+#include "GFXstorage.h"
+
+#define GFX_IMAGE_HEADER_SIZE 8 ///< Bytes before the pixel data
+
+/*!
+  @brief  A 565 RGB image read from GFXstorage. Pass to
+          Adafruit_GFX::drawImage().
+*/
+class GFXimage
+{
+public:
+	GFXimage(GFXstorage &storage, uint32_t addr = 0);
+
+	bool begin(void);
+	int read(void *buffer, int16_t x, int16_t y, uint32_t len);
+
+	int16_t width(void) const;
+	int16_t height(void) const;
+
+private:
+	GFXstorage &_storage;
+	uint32_t _addr; ///< Start of the image (header) in storage
+	int16_t _width, _height;
+};
+
+#endif // _GFXIMAGE_H_
@@ -0,0 +1,147 @@
+/*!
+ * @file GFXmappedCanvas.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Canvases backed by mapped
+ * files or shared memory.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXmappedCanvas.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <atomic>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*!
+    @brief  GFXmappedCanvas16 constructor.
+    @param  w     Canvas width, in pixels.
+    @param  h     Canvas height, in pixels.
+    @param  path  File to map, created if needed; or with shm set, the
+                  shared memory object name (e.g. "/gfx-preview").
+    @param  shm   If true, use a POSIX shared memory object rather than a
+                  file.
+*/
+GFXmappedCanvas16::GFXmappedCanvas16(uint16_t w, uint16_t h, const char *path, bool shm)
+    : GFXcanvas16(w, h, map(w, h, path, shm))
+{
+    _pixels = getBuffer();
+}
+
+/*!
+    @brief  Unmap the canvas. The file (or shared memory object) and its
+            contents stay.
+*/
+GFXmappedCanvas16::~GFXmappedCanvas16(void)
+{
+    if (_pixels)
+        munmap(header(), mappedSize());
+}
+
+/*!
+    @brief  Mark the current contents as a finished frame, for processes
+            viewing the canvas: they can poll the header's sequence number
+            and copy (or show) the pixels whenever it changes.
+*/
+void GFXmappedCanvas16::publish(void)
+{
+    if (!_pixels)
+        return;
+    std::atomic_thread_fence(std::memory_order_release); // Pixels before count
+    header()->sequence++;
+}
+
+/*!
+    @brief   Get the number of frames published, including by earlier runs
+             using the same file.
+    @return  Sequence number, 0 for a new canvas.
+*/
+uint32_t GFXmappedCanvas16::sequence(void) const
+{
+    return _pixels ? header()->sequence : 0;
+}
+
+/*!
+    @brief   Write the canvas back to its file, e.g. to keep a consistent
+             snapshot on disk. Not needed for other processes to see the
+             pixels, which they do as soon as they're drawn.
+    @param   wait  If true, return once written; if false, just schedule
+                   the write.
+    @return  true on success.
+*/
+bool GFXmappedCanvas16::sync(bool wait)
+{
+    return _pixels && !msync(header(), mappedSize(), wait ? MS_SYNC : MS_ASYNC);
+}
+
+/*!
+    @brief   Open (creating or resizing as needed) and map a canvas file or
+             shared memory object.
+    @param   w     Canvas width, in pixels.
+    @param   h     Canvas height, in pixels.
+    @param   path  File path or shared memory object name.
+    @param   shm   If true, path names a shared memory object.
+    @return  Pointer to the first pixel, or NULL on failure.
+*/
+uint16_t *GFXmappedCanvas16::map(uint16_t w, uint16_t h, const char *path, bool shm)
+{
+    size_t size = GFX_MAPPED_HEADER_SIZE + (size_t)w * h * 2;
+    int fd = shm ? shm_open(path, O_RDWR | O_CREAT, 0644) : open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    bool reuse = !fstat(fd, &st) && ((size_t)st.st_size == size);
+    if (!reuse && ftruncate(fd, size))
+    {
+        close(fd);
+        return NULL;
+    }
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file open
+    if (p == MAP_FAILED)
+        return NULL;
+
+    GFXmappedHeader *hdr = (GFXmappedHeader *)p;
+    if (!reuse || memcmp(hdr->magic, "GFXC", 4) || (hdr->width != w) || (hdr->height != h))
+    { // New canvas, or not ours: start blank
+        memset(p, 0, size);
+        memcpy(hdr->magic, "GFXC", 4);
+        hdr->width = w;
+        hdr->height = h;
+    }
+    return (uint16_t *)((uint8_t *)p + GFX_MAPPED_HEADER_SIZE);
+}
+
+/*!
+    @brief   Get the mapping's header.
+    @return  Header, just before the first pixel.
+*/
+GFXmappedHeader *GFXmappedCanvas16::header(void)
+{
+    return (GFXmappedHeader *)((uint8_t *)_pixels - GFX_MAPPED_HEADER_SIZE);
+}
+
+/*!
+    @brief   Get the mapping's header.
+    @return  Header, just before the first pixel.
+*/
+const GFXmappedHeader *GFXmappedCanvas16::header(void) const
+{
+    return (const GFXmappedHeader *)((const uint8_t *)_pixels - GFX_MAPPED_HEADER_SIZE);
+}
+
+/*!
+    @brief   Get the size of the mapping.
+    @return  Header and pixels, in bytes.
+*/
+size_t GFXmappedCanvas16::mappedSize(void) const
+{
+    return GFX_MAPPED_HEADER_SIZE + (size_t)WIDTH * HEIGHT * 2;
+}
+
+#endif // __unix__ || __APPLE__
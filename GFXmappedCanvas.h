@@ -0,0 +1,60 @@
+/*!
+ * @file GFXmappedCanvas.h
+ *
+ * Part of Adafruit's GFX graphics library. Canvases backed by a
+ * memory-mapped file or POSIX shared memory object, for host-side preview
+ * and test tools (Linux, macOS). Surfaces far larger than a screen cost
+ * no heap and no initial copy, a file-backed canvas keeps its contents
+ * between runs, and another process can map the same file or shared
+ * memory object to view frames live, with nothing serialized.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXMAPPEDCANVAS_H_
+#define _GFXMAPPEDCANVAS_H_
+
+#include "Adafruit_GFX.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#define GFX_MAPPED_HEADER_SIZE 16 ///< Bytes before the first pixel
+
+/// Start of a mapped canvas. Pixels follow, row by row, in host byte order.
+typedef struct
+{
+	char magic[4];	 ///< "GFXC"
+	uint16_t width;	///< Canvas width in pixels
+	uint16_t height;   ///< Canvas height in pixels
+	uint32_t sequence; ///< Bumped by publish() after each finished frame
+	uint32_t reserved; ///< Zero
+} GFXmappedHeader;
+
+/*!
+  @brief  A GFXcanvas16 whose pixels live in a mapped file or shared
+          memory object. An existing file of the same size and layout is
+          reused with its contents; anything else is replaced by a blank
+          canvas. Check getBuffer() for NULL to see whether mapping worked.
+*/
+class GFXmappedCanvas16 : public GFXcanvas16
+{
+public:
+	GFXmappedCanvas16(uint16_t w, uint16_t h, const char *path, bool shm = false);
+	~GFXmappedCanvas16(void);
+
+	void publish(void);
+	uint32_t sequence(void) const;
+	bool sync(bool wait = true);
+
+private:
+	static uint16_t *map(uint16_t w, uint16_t h, const char *path, bool shm);
+	GFXmappedHeader *header(void);
+	const GFXmappedHeader *header(void) const;
+	size_t mappedSize(void) const;
+
+	uint16_t *_pixels; ///< Same as getBuffer(), usable from const members
+};
+
+#endif // __unix__ || __APPLE__
+
+#endif // _GFXMAPPEDCANVAS_H_
@@ -0,0 +1,340 @@
+/*!
+ * @file GFXmirror.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Output replayed to several
+ * displays.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXmirror.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief  GFXmirror constructor. Targets are then added with addTarget().
+    @param  w           Drawing surface width, in pixels (at rotation 0).
+    @param  h           Drawing surface height, in pixels (at rotation 0).
+    @param  maxTargets  Number of targets that can be added.
+*/
+GFXmirror::GFXmirror(int16_t w, int16_t h, uint8_t maxTargets)
+    : Adafruit_GFX(w, h), _maxTargets(maxTargets), _count(0)
+{
+    _targets = (Target *)malloc(_maxTargets * sizeof(Target));
+}
+
+/*!
+    @brief  Free the target list. The targets themselves belong to the
+            caller.
+*/
+GFXmirror::~GFXmirror(void)
+{
+    if (_targets)
+        free(_targets);
+}
+
+/*!
+    @brief   Add a device to replay output to.
+    @param   gfx    The device (at the rotation it should be drawn in).
+    @param   x      Where the mirror's top left corner lands on the device.
+    @param   y      Where the mirror's top left corner lands on the device.
+    @param   scale  Device pixels per mirror pixel, each way (e.g. 2 to
+                    show a 160x120 UI on a 320x240 panel).
+    @return  true on success, false if the target list is full or couldn't
+             be allocated.
+*/
+bool GFXmirror::addTarget(Adafruit_GFX &gfx, int16_t x, int16_t y, uint8_t scale)
+{
+    if (!_targets || (_count >= _maxTargets))
+        return false;
+
+    Target *t = &_targets[_count++];
+    t->gfx = &gfx;
+    t->x = x;
+    t->y = y;
+    t->scale = scale ? scale : 1;
+    return true;
+}
+
+/*!
+    @brief   Get the number of targets added.
+    @return  Target count.
+*/
+uint8_t GFXmirror::targets(void) const
+{
+    return _count;
+}
+
+/*!
+    @brief  Draw a pixel on every target.
+    @param  x      Horizontal position (0 = left).
+    @param  y      Vertical position   (0 = top).
+    @param  color  16-bit 5-6-5 pixel color.
+*/
+void GFXmirror::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    int16_t w = 1, h = 1;
+    if (!clip(&x, &y, &w, &h))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Target *t = &_targets[i];
+        if (t->scale == 1)
+            t->gfx->drawPixel(t->x + x, t->y + y, color);
+        else
+            t->gfx->fillRect(t->x + x * t->scale, t->y + y * t->scale, t->scale, t->scale, color);
+    }
+}
+
+/*!
+    @brief  Start a write transaction on every target.
+*/
+void GFXmirror::startWrite(void)
+{
+    for (uint8_t i = 0; i < _count; i++)
+        _targets[i].gfx->startWrite();
+}
+
+/*!
+    @brief  Draw a pixel on every target. Not self-contained; should follow
+            startWrite().
+    @param  x      Horizontal position (0 = left).
+    @param  y      Vertical position   (0 = top).
+    @param  color  16-bit 5-6-5 pixel color.
+*/
+void GFXmirror::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    int16_t w = 1, h = 1;
+    if (!clip(&x, &y, &w, &h))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Target *t = &_targets[i];
+        if (t->scale == 1)
+            t->gfx->writePixel(t->x + x, t->y + y, color);
+        else
+            t->gfx->writeFillRect(t->x + x * t->scale, t->y + y * t->scale, t->scale, t->scale, color);
+    }
+}
+
+/*!
+    @brief  Draw a filled rectangle on every target. Not self-contained;
+            should follow startWrite().
+    @param  x      Top left corner horizontal coordinate.
+    @param  y      Top left corner vertical coordinate.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXmirror::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    replayRect(x, y, w, h, color, false);
+}
+
+/*!
+    @brief  Draw a vertical line on every target. Not self-contained;
+            should follow startWrite().
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  h      Line height in pixels (positive = below first point,
+                   negative = above first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXmirror::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    replayRect(x, y, 1, h, color, false);
+}
+
+/*!
+    @brief  Draw a horizontal line on every target. Not self-contained;
+            should follow startWrite().
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  w      Line width in pixels (positive = right of first point,
+                   negative = left of first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXmirror::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    replayRect(x, y, w, 1, color, false);
+}
+
+/*!
+    @brief  End the write transaction on every target.
+*/
+void GFXmirror::endWrite(void)
+{
+    for (uint8_t i = 0; i < _count; i++)
+        _targets[i].gfx->endWrite();
+}
+
+/*!
+    @brief  Invert the colors of every target.
+    @param  i  true = inverted display, false = normal display.
+*/
+void GFXmirror::invertDisplay(boolean i)
+{
+    for (uint8_t n = 0; n < _count; n++)
+        _targets[n].gfx->invertDisplay(i);
+}
+
+/*!
+    @brief  Draw a vertical line on every target. Self-contained.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  h      Line height in pixels (positive = below first point,
+                   negative = above first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXmirror::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    replayRect(x, y, 1, h, color, true);
+}
+
+/*!
+    @brief  Draw a horizontal line on every target. Self-contained.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  w      Line width in pixels (positive = right of first point,
+                   negative = left of first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXmirror::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    replayRect(x, y, w, 1, color, true);
+}
+
+/*!
+    @brief  Draw a filled rectangle on every target. Self-contained.
+    @param  x      Top left corner horizontal coordinate.
+    @param  y      Top left corner vertical coordinate.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXmirror::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    replayRect(x, y, w, h, color, true);
+}
+
+/*!
+    @brief  Fill the mirrored area of every target.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXmirror::fillScreen(uint16_t color)
+{
+    replayRect(0, 0, _width, _height, color, true);
+}
+
+/*!
+    @brief  Draw a RAM-resident 16-bit image (RGB 5/6/5) on every target.
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  Array of 16-bit 5-6-5 colors.
+    @param  w       Width of bitmap in pixels.
+    @param  h       Height of bitmap in pixels.
+*/
+void GFXmirror::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h)
+{
+    drawRGBSubBitmap(x, y, bitmap, w, w, h);
+}
+
+/*!
+    @brief  Draw a rectangular region of a larger 16-bit image on every
+            target. At rotation 0 unscaled targets are handed the region as
+            is, and scaled targets get each row as runs of same-colored
+            pixels; otherwise the image is drawn pixel by pixel.
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  Pointer to the region's top left pixel.
+    @param  stride  Distance between rows of the image, in pixels.
+    @param  w       Width of region in pixels.
+    @param  h       Height of region in pixels.
+*/
+void GFXmirror::drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h)
+{
+    if (rotation)
+    {
+        Adafruit_GFX::drawRGBSubBitmap(x, y, bitmap, stride, w, h);
+        return;
+    }
+
+    int16_t cx = x, cy = y;
+    if ((w <= 0) || (h <= 0) || !clip(&cx, &cy, &w, &h))
+        return;
+    bitmap += (cy - y) * stride + (cx - x);
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Target *t = &_targets[i];
+        uint8_t s = t->scale;
+        if (s == 1)
+        {
+            t->gfx->drawRGBSubBitmap(t->x + cx, t->y + cy, bitmap, stride, w, h);
+            continue;
+        }
+        t->gfx->startWrite();
+        uint16_t *row = bitmap;
+        for (int16_t j = 0; j < h; j++, row += stride)
+        {
+            for (int16_t i0 = 0, i1; i0 < w; i0 = i1)
+            {
+                for (i1 = i0 + 1; (i1 < w) && (row[i1] == row[i0]); i1++)
+                    ;
+                t->gfx->writeFillRect(t->x + (cx + i0) * s, t->y + (cy + j) * s, (i1 - i0) * s, s, row[i0]);
+            }
+        }
+        t->gfx->endWrite();
+    }
+}
+
+/*!
+    @brief   Convert a rectangle at the current rotation to unrotated
+             coordinates and clip it to the mirrored area.
+    @param   x  Left edge, converted in place.
+    @param   y  Top edge, converted in place.
+    @param   w  Width, converted in place.
+    @param   h  Height, converted in place.
+    @return  false if nothing is left.
+*/
+bool GFXmirror::clip(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const
+{
+    if (!rotateRect(x, y, w, h))
+        return false;
+    int16_t x1 = min(*x + *w, WIDTH), y1 = min(*y + *h, HEIGHT);
+    *x = max(*x, 0);
+    *y = max(*y, 0);
+    *w = x1 - *x;
+    *h = y1 - *y;
+    return (*w > 0) && (*h > 0);
+}
+
+/*!
+    @brief  Replay a rectangle fill to every target, scaled.
+    @param  x      Top left corner horizontal coordinate.
+    @param  y      Top left corner vertical coordinate.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+    @param  self   If true use the targets' self-contained fillRect(),
+                   otherwise writeFillRect() (inside a transaction).
+*/
+void GFXmirror::replayRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color, bool self)
+{
+    if (!clip(&x, &y, &w, &h))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Target *t = &_targets[i];
+        uint8_t s = t->scale;
+        if (self)
+            t->gfx->fillRect(t->x + x * s, t->y + y * s, w * s, h * s, color);
+        else
+            t->gfx->writeFillRect(t->x + x * s, t->y + y * s, w * s, h * s, color);
+    }
+}
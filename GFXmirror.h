@@ -0,0 +1,66 @@
+/*!
+ * @file GFXmirror.h
+ *
+ * Part of Adafruit's GFX graphics library. Mirrored output: one drawing
+ * surface whose output is replayed to several displays, e.g. a local
+ * panel and a secondary one showing the same UI. Lines, circles, text and
+ * the like are rasterized once, by the mirror, into pixels and spans; only
+ * those spans are sent to each display.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXMIRROR_H_
+#define _GFXMIRROR_H_
+
+#include "Adafruit_GFX.h"
+
+/*!
+  @brief  An Adafruit_GFX that replays everything drawn on it to a list of
+          target devices. Each target shows the mirror's (unrotated)
+          coordinate space at an offset and an integer scale, in the
+          target's own current rotation, so targets mounted differently
+          just need setRotation() before being added.
+*/
+class GFXmirror : public Adafruit_GFX
+{
+public:
+	GFXmirror(int16_t w, int16_t h, uint8_t maxTargets = 2);
+	~GFXmirror(void);
+
+	bool addTarget(Adafruit_GFX &gfx, int16_t x = 0, int16_t y = 0, uint8_t scale = 1);
+	uint8_t targets(void) const;
+
+	void drawPixel(int16_t x, int16_t y, uint16_t color);
+	void startWrite(void);
+	void writePixel(int16_t x, int16_t y, uint16_t color);
+	void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void endWrite(void);
+	void invertDisplay(boolean i);
+	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillScreen(uint16_t color);
+	using Adafruit_GFX::drawRGBBitmap; // Check base class first
+	void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h);
+	void drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h);
+
+private:
+	/// One device the output is replayed to
+	struct Target
+	{
+		Adafruit_GFX *gfx; ///< The device
+		int16_t x, y;	  ///< Position of the mirror's top left corner
+		uint8_t scale;	 ///< Device pixels per mirror pixel, each way
+	};
+
+	bool clip(int16_t *x, int16_t *y, int16_t *w, int16_t *h) const;
+	void replayRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color, bool self);
+
+	Target *_targets; ///< maxTargets entries, first _count in use
+	uint8_t _maxTargets, _count;
+};
+
+#endif // _GFXMIRROR_H_
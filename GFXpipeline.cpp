@@ -0,0 +1,282 @@
+/*!
+ * @file GFXpipeline.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Triple-buffered render/flush
+ * pipeline.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXpipeline.h"
+
+#define RING_SIZE (GFX_PIPELINE_BUFFERS + 1) ///< One slot kept empty
+
+/*!
+    @brief  GFXpipeline constructor. Allocates the canvases; check with
+            begin() before use.
+    @param  display  Display finished frames are copied to.
+    @param  w        Frame width, in pixels.
+    @param  h        Frame height, in pixels.
+*/
+GFXpipeline::GFXpipeline(Adafruit_GFX &display, int16_t w, int16_t h)
+    : _display(display), _frame(0), _stopping(false)
+{
+    _free.head = _free.tail = 0;
+    _ready.head = _ready.tail = 0;
+    for (uint8_t i = 0; i < GFX_PIPELINE_BUFFERS; i++)
+    {
+        _canvas[i] = new GFXcanvas16(w, h);
+        give(&_free, i);
+    }
+#if GFX_PIPELINE_THREADS
+    _render = NULL;
+    _arg = NULL;
+    _threads[0] = _threads[1] = NULL;
+#endif
+    resetStats();
+}
+
+/*!
+    @brief  Stop the stage threads, if running, and free the canvases.
+*/
+GFXpipeline::~GFXpipeline(void)
+{
+#if GFX_PIPELINE_THREADS
+    stop();
+#endif
+    for (uint8_t i = 0; i < GFX_PIPELINE_BUFFERS; i++)
+        delete _canvas[i];
+}
+
+/*!
+    @brief   Check that the canvases could be allocated.
+    @return  true if the pipeline is usable.
+*/
+bool GFXpipeline::begin(void)
+{
+    for (uint8_t i = 0; i < GFX_PIPELINE_BUFFERS; i++)
+    {
+        if (!_canvas[i] || !_canvas[i]->getBuffer())
+            return false;
+    }
+    return true;
+}
+
+/*!
+    @brief   Render stage: take a free canvas, draw the next frame into it
+             and queue it for flushing.
+    @param   render  Function drawing the frame.
+    @param   arg     Passed on to render.
+    @param   wait    If true, wait for a free canvas when all three are
+                     queued or being flushed; if false return at once.
+    @return  true if a frame was rendered, false if no canvas was free (or
+             the pipeline is stopping).
+*/
+bool GFXpipeline::renderFrame(GFXrenderFunc render, void *arg, bool wait)
+{
+    uint8_t n;
+    uint32_t t0 = gfxMicros();
+    while (!take(&_free, &n))
+    {
+        if (!wait || _stopping)
+            return false;
+        yield();
+    }
+    uint32_t t1 = gfxMicros();
+    _stats.renderStallUs += t1 - t0;
+
+    render(*_canvas[n], _frame++, arg);
+
+    uint32_t us = gfxMicros() - t1;
+    _stats.rendered++;
+    _stats.renderUs += us;
+    if (us > _stats.renderMaxUs)
+        _stats.renderMaxUs = us;
+    give(&_ready, n);
+    return true;
+}
+
+/*!
+    @brief   Flush stage: copy the oldest finished frame to the display and
+             hand its canvas back to the render stage.
+    @param   wait  If true, wait for a frame when none is queued; if false
+                   return at once.
+    @return  true if a frame was flushed, false if none was queued (or the
+             pipeline is stopping).
+*/
+bool GFXpipeline::flushFrame(bool wait)
+{
+    uint8_t n;
+    uint32_t t0 = gfxMicros();
+    while (!take(&_ready, &n))
+    {
+        if (!wait || _stopping)
+            return false;
+        yield();
+    }
+    uint32_t t1 = gfxMicros();
+    _stats.flushStallUs += t1 - t0;
+    uint8_t queued = count(&_ready) + 1;
+    _stats.depthSum += queued;
+    if (queued > _stats.depthMax)
+        _stats.depthMax = queued;
+
+    GFXcanvas16 *c = _canvas[n];
+    _display.drawRGBSubBitmap(0, 0, c->getBuffer(), c->width(), c->width(), c->height());
+
+    uint32_t us = gfxMicros() - t1;
+    _stats.flushed++;
+    _stats.flushUs += us;
+    if (us > _stats.flushMaxUs)
+        _stats.flushMaxUs = us;
+    give(&_free, n);
+    return true;
+}
+
+#if GFX_PIPELINE_THREADS
+/*!
+    @brief   Start a thread for each stage. The render thread calls render
+             for frame after frame, as fast as the flush thread takes them.
+    @param   render  Function drawing each frame.
+    @param   arg     Passed on to render.
+    @return  true on success, false if already running or the pipeline
+             isn't usable.
+*/
+bool GFXpipeline::start(GFXrenderFunc render, void *arg)
+{
+    if (_threads[0] || !begin())
+        return false;
+    _render = render;
+    _arg = arg;
+    _stopping = false;
+#if defined(__MBED__)
+    _threads[0] = new rtos::Thread();
+    _threads[1] = new rtos::Thread();
+    _threads[0]->start(callback(this, &GFXpipeline::renderLoop));
+    _threads[1]->start(callback(this, &GFXpipeline::flushLoop));
+#else
+    _threads[0] = new std::thread(&GFXpipeline::renderLoop, this);
+    _threads[1] = new std::thread(&GFXpipeline::flushLoop, this);
+#endif
+    return true;
+}
+
+/*!
+    @brief  Stop the stage threads (after the frames in progress) and wait
+            for them to finish. Frames still queued stay queued.
+*/
+void GFXpipeline::stop(void)
+{
+    if (!_threads[0])
+        return;
+    _stopping = true;
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        _threads[i]->join();
+        delete _threads[i];
+        _threads[i] = NULL;
+    }
+}
+#endif // GFX_PIPELINE_THREADS
+
+/*!
+    @brief   Get the number of finished frames waiting to be flushed.
+    @return  Queue depth, 0 to 3.
+*/
+uint8_t GFXpipeline::depth(void) const
+{
+    return count(&_ready);
+}
+
+/*!
+    @brief   Get the pipeline statistics.
+    @return  Statistics since construction or resetStats().
+*/
+const GFXpipelineStats &GFXpipeline::stats(void) const
+{
+    return _stats;
+}
+
+/*!
+    @brief  Clear the pipeline statistics. Best done with the stages idle,
+            as they update the statistics unlocked.
+*/
+void GFXpipeline::resetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+/*!
+    @brief   Remove the canvas number at the head of a ring. Only the ring's
+             consumer may call this.
+    @param   ring  Ring to take from.
+    @param   n     Canvas number, set by function.
+    @return  false if the ring is empty.
+*/
+bool GFXpipeline::take(Ring *ring, uint8_t *n)
+{
+    uint8_t head = ring->head.load(std::memory_order_relaxed);
+    if (head == ring->tail.load(std::memory_order_acquire))
+        return false;
+    *n = ring->slot[head];
+    ring->head.store((head + 1) % RING_SIZE, std::memory_order_release);
+    return true;
+}
+
+/*!
+    @brief  Append a canvas number to a ring. Only the ring's producer may
+            call this; the ring can't overflow, as it has room for every
+            canvas.
+    @param  ring  Ring to add to.
+    @param  n     Canvas number.
+*/
+void GFXpipeline::give(Ring *ring, uint8_t n)
+{
+    uint8_t tail = ring->tail.load(std::memory_order_relaxed);
+    ring->slot[tail] = n;
+    ring->tail.store((tail + 1) % RING_SIZE, std::memory_order_release);
+}
+
+/*!
+    @brief   Get the number of canvases in a ring.
+    @param   ring  Ring to look at.
+    @return  Entries, 0 to GFX_PIPELINE_BUFFERS.
+*/
+uint8_t GFXpipeline::count(const Ring *ring)
+{
+    return (ring->tail.load(std::memory_order_acquire) + RING_SIZE - ring->head.load(std::memory_order_acquire)) % RING_SIZE;
+}
+
+/*!
+    @brief  Let other threads run while a stage waits for the other.
+*/
+void GFXpipeline::yield(void)
+{
+#if GFX_PIPELINE_THREADS
+#if defined(__MBED__)
+    rtos::ThisThread::yield();
+#else
+    std::this_thread::yield();
+#endif
+#endif
+}
+
+#if GFX_PIPELINE_THREADS
+/*!
+    @brief  Render thread body.
+*/
+void GFXpipeline::renderLoop(void)
+{
+    while (!_stopping)
+        renderFrame(_render, _arg);
+}
+
+/*!
+    @brief  Flush thread body.
+*/
+void GFXpipeline::flushLoop(void)
+{
+    while (!_stopping)
+        flushFrame();
+}
+#endif // GFX_PIPELINE_THREADS
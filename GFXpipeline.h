@@ -0,0 +1,125 @@
+/*!
+ * @file GFXpipeline.h
+ *
+ * Part of Adafruit's GFX graphics library. A triple-buffered render/flush
+ * pipeline: frames are drawn into one of three canvases while a
+ * previously finished frame is being copied to the display, so on a
+ * dual-core part (or with a DMA-driven display) rendering of frame N+1
+ * overlaps the transfer of frame N. The render and flush stages hand
+ * canvases to each other through two single-producer single-consumer
+ * rings, without locks, and may run on their own threads (started by
+ * start(), using mbed RTOS threads or std::thread on a host) or be called
+ * from threads the application manages.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXPIPELINE_H_
+#define _GFXPIPELINE_H_
+
+#include "Adafruit_GFX.h"
+#include <atomic>
+
+#if defined(__MBED__)
+#if MBED_CONF_RTOS_PRESENT
+#include "rtos.h"
+#define GFX_PIPELINE_THREADS 1 ///< start()/stop() available
+#endif
+#else
+#include <thread>
+#define GFX_PIPELINE_THREADS 1 ///< start()/stop() available
+#endif
+
+#define GFX_PIPELINE_BUFFERS 3 ///< Canvases in the pipeline
+
+/*!
+  @brief  Draws one frame. Called by the render stage with a canvas
+          holding an older frame (not cleared).
+  @param  canvas  Canvas to draw the frame into.
+  @param  frame   Frame number, counting from 0.
+  @param  arg     Application pointer given to renderFrame() or start().
+*/
+typedef void (*GFXrenderFunc)(GFXcanvas16 &canvas, uint32_t frame, void *arg);
+
+/// Pipeline statistics. Each stage only writes its own fields.
+typedef struct
+{
+	uint32_t rendered;		///< Frames rendered
+	uint32_t renderUs;		///< Total time spent in the render function
+	uint32_t renderMaxUs;	///< Slowest frame render
+	uint32_t renderStallUs; ///< Time render stage waited for a free canvas
+	uint32_t flushed;		///< Frames flushed
+	uint32_t flushUs;		///< Total time spent copying frames out
+	uint32_t flushMaxUs;	///< Slowest frame flush
+	uint32_t flushStallUs;  ///< Time flush stage waited for a finished frame
+	uint32_t depthSum;		///< Sum of frames queued, sampled at each flush
+	uint8_t depthMax;		///< Most frames ever queued for flushing
+} GFXpipelineStats;
+
+/*!
+  @brief  Three GFXcanvas16 frames cycling between a render stage and a
+          flush stage that copies them to a display. With one stage much
+          slower than the other, the stats show it: a slow flush makes the
+          render stage stall (renderStallUs) with the queue full, a slow
+          render starves the flush stage (flushStallUs) with it empty.
+*/
+class GFXpipeline
+{
+public:
+	GFXpipeline(Adafruit_GFX &display, int16_t w, int16_t h);
+	~GFXpipeline(void);
+
+	bool begin(void);
+
+	// Stages, each to be called from one thread only:
+	bool renderFrame(GFXrenderFunc render, void *arg, bool wait = true);
+	bool flushFrame(bool wait = true);
+
+#if GFX_PIPELINE_THREADS
+	// Run both stages on their own threads:
+	bool start(GFXrenderFunc render, void *arg);
+	void stop(void);
+#endif
+
+	uint8_t depth(void) const;
+	const GFXpipelineStats &stats(void) const;
+	void resetStats(void);
+
+private:
+	/// Lock-free queue of canvas numbers, one producer and one consumer
+	struct Ring
+	{
+		uint8_t slot[GFX_PIPELINE_BUFFERS + 1]; ///< Canvas numbers
+		std::atomic<uint8_t> head;				///< Next to take (consumer)
+		std::atomic<uint8_t> tail;				///< Next to fill (producer)
+	};
+
+	static bool take(Ring *ring, uint8_t *n);
+	static void give(Ring *ring, uint8_t n);
+	static uint8_t count(const Ring *ring);
+	void yield(void);
+
+#if GFX_PIPELINE_THREADS
+	void renderLoop(void);
+	void flushLoop(void);
+#endif
+
+	Adafruit_GFX &_display;
+	GFXcanvas16 *_canvas[GFX_PIPELINE_BUFFERS];
+	Ring _free;	 ///< Canvases the render stage may draw into
+	Ring _ready; ///< Finished frames, oldest first
+	uint32_t _frame;
+	std::atomic<bool> _stopping;
+	GFXpipelineStats _stats;
+#if GFX_PIPELINE_THREADS
+	GFXrenderFunc _render;
+	void *_arg;
+#if defined(__MBED__)
+	rtos::Thread *_threads[2];
+#else
+	std::thread *_threads[2];
+#endif
+#endif
+};
+
+#endif // _GFXPIPELINE_H_
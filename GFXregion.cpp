@@ -0,0 +1,489 @@
+/*!
+ * @file GFXregion.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Region algebra on banded boxes.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXregion.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+// Operations for combine():
+#define GFX_REGION_UNION 0	 ///< Pixels in either region
+#define GFX_REGION_INTERSECT 1 ///< Pixels in both regions
+#define GFX_REGION_SUBTRACT 2  ///< Pixels in the first region only
+
+#define GFX_REGION_NONE 0xFFFF ///< emitBand(): no band above
+
+/*!
+    @brief   Find the end of the band starting at a box.
+    @param   p    First box of the band.
+    @param   end  End of the box list.
+    @return  First box of the next band (or end).
+*/
+static const GFXbox *bandEnd(const GFXbox *p, const GFXbox *end)
+{
+    const GFXbox *q = p;
+    while ((q < end) && (q->y0 == p->y0))
+        q++;
+    return q;
+}
+
+/*!
+    @brief  GFXregion constructor. The region starts empty.
+    @param  pool      Box storage, used by this region only. Operations need
+                      room for their result besides the current boxes, so
+                      allow about twice the boxes the region is expected to
+                      hold.
+    @param  capacity  Number of boxes in pool.
+*/
+GFXregion::GFXregion(GFXbox *pool, uint16_t capacity)
+    : _boxes(pool), _capacity(pool ? capacity : 0), _count(0)
+{
+}
+
+/*!
+    @brief  Make the region empty.
+*/
+void GFXregion::clear(void)
+{
+    _count = 0;
+}
+
+/*!
+    @brief   Make the region a single rectangle.
+    @param   x  Left edge.
+    @param   y  Top edge.
+    @param   w  Width (0 or less: empty region).
+    @param   h  Height (0 or less: empty region).
+    @return  false if the pool has no room.
+*/
+bool GFXregion::set(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    _count = 0;
+    if ((w <= 0) || (h <= 0))
+        return true;
+    if (!_capacity)
+        return false;
+    GFXbox box = {x, y, (int16_t)(x + w), (int16_t)(y + h)};
+    _boxes[_count++] = box;
+    return true;
+}
+
+/*!
+    @brief   Make the region a copy of another.
+    @param   r  Region to copy.
+    @return  false if it didn't fit (the region is then r's bounding box).
+*/
+bool GFXregion::set(const GFXregion &r)
+{
+    if (&r == this)
+        return true;
+    if (r._count > _capacity)
+    {
+        GFXbox box;
+        r.extents(&box);
+        set(box.x0, box.y0, box.x1 - box.x0, box.y1 - box.y0);
+        return false;
+    }
+    memcpy(_boxes, r._boxes, r._count * sizeof(GFXbox));
+    _count = r._count;
+    return true;
+}
+
+/*!
+    @brief   Add another region's pixels.
+    @param   r  Region to add (may be this region).
+    @return  false if the result didn't fit (the region is then the
+             bounding box of both).
+*/
+bool GFXregion::unite(const GFXregion &r)
+{
+    return combine(r._boxes, r._count, GFX_REGION_UNION);
+}
+
+/*!
+    @brief   Add a rectangle.
+    @param   x  Left edge.
+    @param   y  Top edge.
+    @param   w  Width.
+    @param   h  Height.
+    @return  false if the result didn't fit (the region is then the
+             bounding box of both).
+*/
+bool GFXregion::unite(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    GFXbox box = {x, y, (int16_t)(x + w), (int16_t)(y + h)};
+    return combine(&box, ((w > 0) && (h > 0)) ? 1 : 0, GFX_REGION_UNION);
+}
+
+/*!
+    @brief   Keep only the pixels also in another region.
+    @param   r  Region to intersect with (may be this region).
+    @return  false if the result didn't fit (the region is then unchanged,
+             a superset of the result: clear it if used for clipping).
+*/
+bool GFXregion::intersect(const GFXregion &r)
+{
+    return combine(r._boxes, r._count, GFX_REGION_INTERSECT);
+}
+
+/*!
+    @brief   Keep only the pixels within a rectangle (clip).
+    @param   x  Left edge.
+    @param   y  Top edge.
+    @param   w  Width.
+    @param   h  Height.
+    @return  false if the result didn't fit (the region is then unchanged,
+             a superset of the result: clear it if used for clipping).
+*/
+bool GFXregion::intersect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    GFXbox box = {x, y, (int16_t)(x + w), (int16_t)(y + h)};
+    return combine(&box, ((w > 0) && (h > 0)) ? 1 : 0, GFX_REGION_INTERSECT);
+}
+
+/*!
+    @brief   Remove another region's pixels.
+    @param   r  Region to remove (may be this region).
+    @return  false if the result didn't fit (the region is then unchanged,
+             a superset of the result: clear it if used for clipping).
+*/
+bool GFXregion::subtract(const GFXregion &r)
+{
+    return combine(r._boxes, r._count, GFX_REGION_SUBTRACT);
+}
+
+/*!
+    @brief   Remove a rectangle.
+    @param   x  Left edge.
+    @param   y  Top edge.
+    @param   w  Width.
+    @param   h  Height.
+    @return  false if the result didn't fit (the region is then unchanged,
+             a superset of the result: clear it if used for clipping).
+*/
+bool GFXregion::subtract(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    GFXbox box = {x, y, (int16_t)(x + w), (int16_t)(y + h)};
+    return combine(&box, ((w > 0) && (h > 0)) ? 1 : 0, GFX_REGION_SUBTRACT);
+}
+
+/*!
+    @brief  Move the region.
+    @param  dx  Horizontal offset.
+    @param  dy  Vertical offset.
+*/
+void GFXregion::translate(int16_t dx, int16_t dy)
+{
+    for (uint16_t i = 0; i < _count; i++)
+    {
+        _boxes[i].x0 += dx;
+        _boxes[i].x1 += dx;
+        _boxes[i].y0 += dy;
+        _boxes[i].y1 += dy;
+    }
+}
+
+/*!
+    @brief   Query whether the region is empty.
+    @return  true if it has no pixels.
+*/
+bool GFXregion::empty(void) const
+{
+    return !_count;
+}
+
+/*!
+    @brief   Query whether a pixel is in the region.
+    @param   x  Horizontal position.
+    @param   y  Vertical position.
+    @return  true if it is.
+*/
+bool GFXregion::contains(int16_t x, int16_t y) const
+{
+    for (uint16_t i = 0; (i < _count) && (_boxes[i].y0 <= y); i++)
+    {
+        const GFXbox &b = _boxes[i];
+        if ((y < b.y1) && (x >= b.x0) && (x < b.x1))
+            return true;
+    }
+    return false;
+}
+
+/*!
+    @brief   Query whether a rectangle is entirely in the region.
+    @param   x  Left edge.
+    @param   y  Top edge.
+    @param   w  Width.
+    @param   h  Height.
+    @return  true if it is (always, for an empty rectangle).
+*/
+bool GFXregion::contains(int16_t x, int16_t y, int16_t w, int16_t h) const
+{
+    if ((w <= 0) || (h <= 0))
+        return true;
+    const GFXbox *p = _boxes, *end = _boxes + _count;
+    int32_t row = y; // First row not yet known to be covered
+    while ((p < end) && (row < y + h))
+    {
+        const GFXbox *e = bandEnd(p, end);
+        if (p->y1 > row)
+        {
+            if (p->y0 > row)
+                return false; // Gap between bands
+            const GFXbox *q = p;
+            while ((q < e) && !((q->x0 <= x) && (q->x1 >= x + w)))
+                q++;
+            if (q == e)
+                return false; // Band doesn't span the rectangle
+            row = p->y1;
+        }
+        p = e;
+    }
+    return row >= y + h;
+}
+
+/*!
+    @brief   Get the smallest rectangle containing the region.
+    @param   box  Set to the bounding box (all 0 if the region is empty).
+    @return  false if the region is empty.
+*/
+bool GFXregion::extents(GFXbox *box) const
+{
+    if (!_count)
+    {
+        box->x0 = box->y0 = box->x1 = box->y1 = 0;
+        return false;
+    }
+    box->x0 = _boxes[0].x0;
+    box->x1 = _boxes[0].x1;
+    box->y0 = _boxes[0].y0;
+    box->y1 = _boxes[_count - 1].y1;
+    for (uint16_t i = 1; i < _count; i++)
+    {
+        box->x0 = min(box->x0, _boxes[i].x0);
+        box->x1 = max(box->x1, _boxes[i].x1);
+    }
+    return true;
+}
+
+/*!
+    @brief   Count the pixels in the region.
+    @return  Number of pixels.
+*/
+uint32_t GFXregion::area(void) const
+{
+    uint32_t a = 0;
+    for (uint16_t i = 0; i < _count; i++)
+        a += (uint32_t)(_boxes[i].x1 - _boxes[i].x0) * (_boxes[i].y1 - _boxes[i].y0);
+    return a;
+}
+
+/*!
+    @brief   Get the number of boxes making up the region.
+    @return  Box count.
+*/
+uint16_t GFXregion::size(void) const
+{
+    return _count;
+}
+
+/*!
+    @brief   Get the boxes making up the region, in scanline order (top to
+             bottom, then left to right). Each is one address window.
+    @return  size() boxes.
+*/
+const GFXbox *GFXregion::boxes(void) const
+{
+    return _boxes;
+}
+
+/*!
+    @brief  Fill the region on a device, one rectangle per box in a single
+            transaction.
+    @param  gfx    Device.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXregion::fill(Adafruit_GFX &gfx, uint16_t color) const
+{
+    gfx.startWrite();
+    for (uint16_t i = 0; i < _count; i++)
+    {
+        const GFXbox &b = _boxes[i];
+        gfx.writeFillRect(b.x0, b.y0, b.x1 - b.x0, b.y1 - b.y0, color);
+    }
+    gfx.endWrite();
+}
+
+/*!
+    @brief  Copy the region of a canvas (e.g. holding the screen contents,
+            at rotation 0) to a device, one bitmap push per box.
+    @param  canvas  Source canvas; the region is clipped to it.
+    @param  gfx     Device.
+*/
+void GFXregion::copy(GFXcanvas16 &canvas, Adafruit_GFX &gfx) const
+{
+    uint16_t *buffer = canvas.getBuffer();
+    if (!buffer)
+        return;
+    int16_t cw = canvas.width(), ch = canvas.height();
+    for (uint16_t i = 0; i < _count; i++)
+    {
+        const GFXbox &b = _boxes[i];
+        int16_t x0 = max(b.x0, 0), y0 = max(b.y0, 0);
+        int16_t x1 = min(b.x1, cw), y1 = min(b.y1, ch);
+        if ((x0 < x1) && (y0 < y1))
+            gfx.drawRGBSubBitmap(x0, y0, buffer + (int32_t)y0 * cw + x0, cw, x1 - x0, y1 - y0);
+    }
+}
+
+/*!
+    @brief   Combine the region with a banded box list. The two are swept
+             top to bottom, one span of rows at a time where neither
+             changes; the result is built after the current boxes and then
+             moved down.
+    @param   b   Boxes (a region's, possibly this one's, or a single box).
+    @param   nb  Number of boxes.
+    @param   op  GFX_REGION_UNION, GFX_REGION_INTERSECT or
+                 GFX_REGION_SUBTRACT.
+    @return  false if the result didn't fit.
+*/
+bool GFXregion::combine(const GFXbox *b, uint16_t nb, uint8_t op)
+{
+    const GFXbox *a = _boxes, *aEnd = _boxes + _count, *bEnd = b + nb;
+    uint16_t out = _count, prevBand = GFX_REGION_NONE;
+    int32_t y = INT16_MIN;
+
+    while ((a < aEnd) || (b < bEnd))
+    {
+        while ((a < aEnd) && (a->y1 <= y))
+            a = bandEnd(a, aEnd);
+        while ((b < bEnd) && (b->y1 <= y))
+            b = bandEnd(b, bEnd);
+        if ((a == aEnd) && (b == bEnd))
+            break;
+
+        // Rows from y to yEnd: each list either in one band or between
+        bool aIn = (a < aEnd) && (a->y0 <= y), bIn = (b < bEnd) && (b->y0 <= y);
+        int32_t yEnd = INT32_MAX;
+        if (a < aEnd)
+            yEnd = aIn ? a->y1 : a->y0;
+        if (b < bEnd)
+            yEnd = min(yEnd, bIn ? b->y1 : b->y0);
+        bool any = (op == GFX_REGION_UNION) ? (aIn || bIn) : (op == GFX_REGION_INTERSECT) ? (aIn && bIn) : aIn;
+        if (any)
+        {
+            const GFXbox *ae = aIn ? bandEnd(a, aEnd) : a, *be = bIn ? bandEnd(b, bEnd) : b;
+            if (!emitBand(&out, y, yEnd, a, ae - a, b, be - b, op, &prevBand))
+            {
+                if (op == GFX_REGION_UNION)
+                { // Fall back to the bounding box of both
+                    GFXbox box;
+                    bool has = extents(&box);
+                    for (const GFXbox *p = bEnd - nb; p < bEnd; p++)
+                    {
+                        if (!has)
+                            box = *p;
+                        has = true;
+                        box.x0 = min(box.x0, p->x0);
+                        box.y0 = min(box.y0, p->y0);
+                        box.x1 = max(box.x1, p->x1);
+                        box.y1 = max(box.y1, p->y1);
+                    }
+                    set(box.x0, box.y0, box.x1 - box.x0, box.y1 - box.y0);
+                }
+                return false;
+            }
+        }
+        y = yEnd;
+    }
+
+    uint16_t n = out - _count;
+    memmove(_boxes, _boxes + _count, n * sizeof(GFXbox));
+    _count = n;
+    return true;
+}
+
+/*!
+    @brief   Append the boxes of one band of a result: the spans of a row
+             of the first list and a row of the second that the operation
+             keeps. The band is merged into the one above when they touch
+             and have the same spans.
+    @param   out       Next free box, advanced.
+    @param   y0        Top row of the band.
+    @param   y1        Bottom row of the band + 1.
+    @param   a         Boxes of the first list's band (x spans only used).
+    @param   na        Number of boxes (0 if not in a band).
+    @param   b         Boxes of the second list's band.
+    @param   nb        Number of boxes.
+    @param   op        GFX_REGION_UNION, etc.
+    @param   prevBand  First box of the previous band appended, updated.
+    @return  false if the pool is full.
+*/
+bool GFXregion::emitBand(uint16_t *out, int16_t y0, int16_t y1, const GFXbox *a, uint16_t na, const GFXbox *b, uint16_t nb, uint8_t op, uint16_t *prevBand)
+{
+    uint16_t start = *out, ia = 0, ib = 0;
+    bool inA = false, inB = false, inResult = false;
+    int16_t x0 = 0;
+    for (;;)
+    {
+        int32_t xa = (ia < na) ? (inA ? a[ia].x1 : a[ia].x0) : INT32_MAX;
+        int32_t xb = (ib < nb) ? (inB ? b[ib].x1 : b[ib].x0) : INT32_MAX;
+        int32_t x = min(xa, xb);
+        if (x == INT32_MAX)
+            break;
+        if (xa == x)
+        {
+            if (inA)
+                ia++;
+            inA = !inA;
+        }
+        if (xb == x)
+        {
+            if (inB)
+                ib++;
+            inB = !inB;
+        }
+        bool r = (op == GFX_REGION_UNION) ? (inA || inB) : (op == GFX_REGION_INTERSECT) ? (inA && inB) : (inA && !inB);
+        if (r && !inResult)
+        {
+            x0 = x;
+            inResult = true;
+        }
+        else if (!r && inResult)
+        {
+            if (*out == _capacity)
+                return false;
+            GFXbox box = {x0, y0, (int16_t)x, y1};
+            _boxes[(*out)++] = box;
+            inResult = false;
+        }
+    }
+
+    uint16_t n = *out - start;
+    if (!n)
+        return true;
+    if ((*prevBand != GFX_REGION_NONE) && (start - *prevBand == n) && (_boxes[*prevBand].y1 == y0))
+    {
+        uint16_t i = 0;
+        while ((i < n) && (_boxes[*prevBand + i].x0 == _boxes[start + i].x0) && (_boxes[*prevBand + i].x1 == _boxes[start + i].x1))
+            i++;
+        if (i == n)
+        { // Same spans: extend the band above instead
+            for (i = 0; i < n; i++)
+                _boxes[*prevBand + i].y1 = y1;
+            *out = start;
+            return true;
+        }
+    }
+    *prevBand = start;
+    return true;
+}
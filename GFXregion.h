@@ -0,0 +1,76 @@
+/*!
+ * @file GFXregion.h
+ *
+ * Part of Adafruit's GFX graphics library. Regions: sets of pixels kept
+ * as rectangles, for dirty tracking, clipping and occlusion. As with X11
+ * regions, the rectangles (boxes) are disjoint and banded: sorted top to
+ * bottom then left to right, every box of a band spanning the same rows,
+ * boxes touching in a row merged, and identical bands stacked vertically
+ * merged, so the boxes are also the address windows to send to a display
+ * in scanline order. Boxes live in a pool supplied by the caller; union,
+ * intersection and subtraction build their result in the unused part of
+ * the pool, so nothing is allocated.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXREGION_H_
+#define _GFXREGION_H_
+
+#include "Adafruit_GFX.h"
+
+/// Region rectangle; includes (x0, y0), excludes x1 and y1
+typedef struct
+{
+	int16_t x0, y0; ///< Top left corner
+	int16_t x1, y1; ///< Bottom right corner + 1
+} GFXbox;
+
+/*!
+  @brief  Set of pixels as banded boxes in a caller-supplied pool. An
+          operation whose result doesn't fit the pool returns false and
+          leaves a region that still contains the exact result (union:
+          the bounding box of both; intersection, subtraction: unchanged).
+          That superset is safe for invalidation (more is redrawn), NOT
+          for clipping: a clip region must be cleared (or otherwise
+          replaced) when an operation returns false, or drawing escapes
+          it.
+*/
+class GFXregion
+{
+public:
+	GFXregion(GFXbox *pool, uint16_t capacity);
+
+	void clear(void);
+	bool set(int16_t x, int16_t y, int16_t w, int16_t h);
+	bool set(const GFXregion &r);
+
+	bool unite(const GFXregion &r);
+	bool unite(int16_t x, int16_t y, int16_t w, int16_t h);
+	bool intersect(const GFXregion &r);
+	bool intersect(int16_t x, int16_t y, int16_t w, int16_t h);
+	bool subtract(const GFXregion &r);
+	bool subtract(int16_t x, int16_t y, int16_t w, int16_t h);
+	void translate(int16_t dx, int16_t dy);
+
+	bool empty(void) const;
+	bool contains(int16_t x, int16_t y) const;
+	bool contains(int16_t x, int16_t y, int16_t w, int16_t h) const;
+	bool extents(GFXbox *box) const;
+	uint32_t area(void) const;
+
+	uint16_t size(void) const;
+	const GFXbox *boxes(void) const;
+
+	void fill(Adafruit_GFX &gfx, uint16_t color) const;
+	void copy(GFXcanvas16 &canvas, Adafruit_GFX &gfx) const;
+
+private:
+	bool combine(const GFXbox *b, uint16_t nb, uint8_t op);
+	bool emitBand(uint16_t *out, int16_t y0, int16_t y1, const GFXbox *a, uint16_t na, const GFXbox *b, uint16_t nb, uint8_t op, uint16_t *prevBand);
+
+	GFXbox *_boxes;		///< capacity entries, first _count in use
+	uint16_t _capacity, _count;
+};
+
+#endif // _GFXREGION_H_
@@ -0,0 +1,202 @@
+/*!
+ * @file GFXrenderJob.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Time-sliced fills and bitmap
+ * pushes.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXrenderJob.h"
+
+#define GFX_JOB_SLICE 256 ///< Pixels per band in stepFor()
+
+/*!
+    @brief  GFXrenderJob constructor. The job starts out idle.
+    @param  gfx  Device (or canvas) the jobs draw to.
+*/
+GFXrenderJob::GFXrenderJob(Adafruit_GFX &gfx)
+    : _gfx(gfx), _type(JOB_NONE), _x(0), _y(0), _w(0), _h(0), _row(0), _color(0), _bitmap(NULL)
+{
+}
+
+/*!
+    @brief  Set up a rectangle fill job.
+    @param  x      Top left corner x coordinate.
+    @param  y      Top left corner y coordinate.
+    @param  w      Width in pixels, negative to fill left of x.
+    @param  h      Height in pixels, negative to fill above y.
+    @param  color  16-bit 5-6-5 color to fill with.
+*/
+void GFXrenderJob::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (w < 0)
+    {               // If negative width...
+        x += w + 1; //   Move X to left edge
+        w = -w;     //   Use positive width
+    }
+    if (h < 0)
+    {               // If negative height...
+        y += h + 1; //   Move Y to top edge
+        h = -h;     //   Use positive height
+    }
+    if (x < 0)
+    { // Fills are clipped up front so steps aren't spent offscreen
+        w += x;
+        x = 0;
+    }
+    if (x + w > _gfx.width())
+        w = _gfx.width() - x;
+    _color = color;
+    start(JOB_FILL, x, y, w, h);
+}
+
+/*!
+    @brief  Set up a job filling the whole display.
+    @param  color  16-bit 5-6-5 color to fill with.
+*/
+void GFXrenderJob::fillScreen(uint16_t color)
+{
+    fillRect(0, 0, _gfx.width(), _gfx.height(), color);
+}
+
+/*!
+    @brief  Set up a job drawing a PROGMEM-resident 16-bit image. The bitmap
+            must stay valid until the job finishes or is cancelled.
+    @param  x       Top left corner x coordinate.
+    @param  y       Top left corner y coordinate.
+    @param  bitmap  Array of 16-bit 5-6-5 colors.
+    @param  w       Width of bitmap in pixels.
+    @param  h       Height of bitmap in pixels.
+*/
+void GFXrenderJob::drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h)
+{
+    _bitmap = bitmap;
+    start(JOB_BITMAP_PGM, x, y, w, h);
+}
+
+/*!
+    @brief  Set up a job drawing a RAM-resident 16-bit image. The bitmap
+            must stay valid (and unchanged) until the job finishes or is
+            cancelled.
+    @param  x       Top left corner x coordinate.
+    @param  y       Top left corner y coordinate.
+    @param  bitmap  Array of 16-bit 5-6-5 colors.
+    @param  w       Width of bitmap in pixels.
+    @param  h       Height of bitmap in pixels.
+*/
+void GFXrenderJob::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h)
+{
+    _bitmap = bitmap;
+    start(JOB_BITMAP, x, y, w, h);
+}
+
+/*!
+    @brief   Draw the next rows of the job, as many whole rows as fit the
+             budget (always at least one).
+    @param   maxPixels  Pixel budget for this step.
+    @return  true if work remains, false if the job is done (or idle).
+*/
+bool GFXrenderJob::step(uint32_t maxPixels)
+{
+    if (_type == JOB_NONE)
+        return false;
+
+    int16_t rows = _h - _row;
+    if ((uint32_t)rows * _w > maxPixels)
+        rows = (maxPixels > (uint32_t)_w) ? (maxPixels / _w) : 1;
+
+    int16_t y = _y + _row;
+    const uint16_t *bitmap = _bitmap + (uint32_t)_row * _w;
+    switch (_type)
+    {
+    case JOB_FILL:
+        _gfx.fillRect(_x, y, _w, rows, _color);
+        break;
+    case JOB_BITMAP:
+        _gfx.drawRGBBitmap(_x, y, (uint16_t *)bitmap, _w, rows);
+        break;
+    default:
+        _gfx.drawRGBBitmap(_x, y, bitmap, _w, rows);
+        break;
+    }
+
+    if ((_row += rows) >= _h)
+        _type = JOB_NONE;
+    return _type != JOB_NONE;
+}
+
+/*!
+    @brief   Draw rows of the job until a time budget is used up. Rows go
+             out in small bands and the clock is checked between bands, so
+             a step overruns the budget by at most one band (and always
+             draws at least one).
+    @param   us  Time budget for this step, in microseconds.
+    @return  true if work remains, false if the job is done (or idle).
+*/
+bool GFXrenderJob::stepFor(uint32_t us)
+{
+    uint32_t t0 = gfxMicros();
+    while (step(GFX_JOB_SLICE))
+    {
+        if ((gfxMicros() - t0) >= us)
+            return true;
+    }
+    return false;
+}
+
+/*!
+    @brief  Abandon the job. Rows already drawn stay on the display.
+*/
+void GFXrenderJob::cancel(void)
+{
+    _type = JOB_NONE;
+}
+
+/*!
+    @brief   Query whether a job is in progress.
+    @return  true if step() has work to do.
+*/
+bool GFXrenderJob::busy(void) const
+{
+    return _type != JOB_NONE;
+}
+
+/*!
+    @brief   Get the amount of work left.
+    @return  Pixels still to be drawn, 0 if idle.
+*/
+uint32_t GFXrenderJob::remaining(void) const
+{
+    return (_type == JOB_NONE) ? 0 : (uint32_t)(_h - _row) * _w;
+}
+
+/*!
+    @brief   Get the fraction of the job done.
+    @return  Percent complete, 0-100 (100 if idle).
+*/
+uint8_t GFXrenderJob::progress(void) const
+{
+    return (_type == JOB_NONE) ? 100 : (uint32_t)_row * 100 / _h;
+}
+
+/*!
+    @brief  Common job setup. Rows above or below the display are skipped
+            here rather than spending steps on them.
+    @param  type  Job type (bitmap pointer/color already set).
+    @param  x     Top left corner x coordinate.
+    @param  y     Top left corner y coordinate.
+    @param  w     Width in pixels.
+    @param  h     Height in pixels.
+*/
+void GFXrenderJob::start(JobType type, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    _x = x;
+    _y = y;
+    _w = w;
+    _h = h;
+    _row = (y < 0) ? -y : 0;
+    if (y + h > _gfx.height())
+        _h = _gfx.height() - y;
+    _type = ((w > 0) && (_row < _h)) ? type : JOB_NONE;
+}
@@ -0,0 +1,63 @@
+/*!
+ * @file GFXrenderJob.h
+ *
+ * Part of Adafruit's GFX graphics library. Time-sliced rendering: large
+ * fills and bitmap pushes that would otherwise block for tens of
+ * milliseconds are set up as a job and then advanced a bounded amount at
+ * a time with step(), so display work can be interleaved with a control
+ * loop (or kept short enough for a watchdog) without an RTOS.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXRENDERJOB_H_
+#define _GFXRENDERJOB_H_
+
+#include "Adafruit_GFX.h"
+
+/*!
+  @brief  A resumable fill or bitmap push on any Adafruit_GFX device. Work
+          is done in whole rows (bands), each band in its own transaction,
+          so the bus is released between steps.
+*/
+class GFXrenderJob
+{
+public:
+	GFXrenderJob(Adafruit_GFX &gfx);
+
+	// Set up a job (replacing any job in progress; nothing is drawn yet):
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillScreen(uint16_t color);
+	void drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h);
+	void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h);
+
+	// Advance the job; both return true while work remains:
+	bool step(uint32_t maxPixels);
+	bool stepFor(uint32_t us);
+
+	void cancel(void);
+	bool busy(void) const;
+	uint32_t remaining(void) const;
+	uint8_t progress(void) const;
+
+private:
+	/// What the current job does
+	enum JobType
+	{
+		JOB_NONE,
+		JOB_FILL,
+		JOB_BITMAP,	///< RAM-resident bitmap
+		JOB_BITMAP_PGM ///< PROGMEM-resident bitmap
+	};
+
+	void start(JobType type, int16_t x, int16_t y, int16_t w, int16_t h);
+
+	Adafruit_GFX &_gfx;
+	JobType _type;
+	int16_t _x, _y, _w, _h;
+	int16_t _row; ///< Next row to draw, relative to _y
+	uint16_t _color;
+	const uint16_t *_bitmap;
+};
+
+#endif // _GFXRENDERJOB_H_
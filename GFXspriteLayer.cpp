@@ -0,0 +1,339 @@
+/*!
+ * @file GFXspriteLayer.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Band-composed sprites.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXspriteLayer.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief  Store a pixel in display (big-endian) byte order.
+    @param  dst    Where to store it.
+    @param  color  16-bit 5-6-5 color.
+*/
+static inline void putPixel(uint16_t *dst, uint16_t color)
+{
+    uint8_t *p = (uint8_t *)dst;
+    p[0] = color >> 8;
+    p[1] = color;
+}
+
+/*!
+    @brief  GFXspriteLayer constructor. Allocates the band buffers (two if
+            there is room, so composing overlaps sending) and marks the
+            whole screen for the first update(). Buffers are sized for
+            any rotation.
+    @param  tft       Display.
+    @param  sprites   Sprites, kept (not copied); MUST outlive the layer.
+    @param  count     Number of sprites.
+    @param  bandRows  Rows composed at a time; each buffer takes
+                      2 * bandRows * (longer screen side) bytes. Falls back
+                      to 1 if that can't be allocated.
+*/
+GFXspriteLayer::GFXspriteLayer(Adafruit_SPITFT &tft, GFXsprite *sprites, uint8_t count, uint8_t bandRows)
+    : _tft(tft), _sprites(sprites), _count(count), _bgColor(0), _tile(NULL), _tileW(0), _tileH(0)
+{
+    int16_t side = max(tft.width(), tft.height());
+    _bandRows = max(bandRows, 1);
+    _buf[0] = (uint16_t *)malloc(side * _bandRows * sizeof(uint16_t));
+    if (!_buf[0] && (_bandRows > 1))
+    {
+        _bandRows = 1;
+        _buf[0] = (uint16_t *)malloc(side * sizeof(uint16_t));
+    }
+    _buf[1] = _buf[0] ? (uint16_t *)malloc(side * _bandRows * sizeof(uint16_t)) : NULL;
+    _bands = (side + _bandRows - 1) / _bandRows;
+    _dirty = (int16_t *)malloc(_bands * 2 * sizeof(int16_t));
+    _order = (uint8_t *)malloc(count ? count : 1);
+    for (uint8_t i = 0; _order && (i < count); i++)
+        _order[i] = i;
+    sortSprites();
+    invalidateAll();
+}
+
+/*!
+    @brief  Free the buffers.
+*/
+GFXspriteLayer::~GFXspriteLayer(void)
+{
+    if (_buf[0])
+        free(_buf[0]);
+    if (_buf[1])
+        free(_buf[1]);
+    if (_dirty)
+        free(_dirty);
+    if (_order)
+        free(_order);
+}
+
+/*!
+    @brief  Use a solid background, and redraw everything.
+    @param  color  16-bit 5-6-5 color.
+*/
+void GFXspriteLayer::setBackground(uint16_t color)
+{
+    _bgColor = color;
+    _tile = NULL;
+    invalidateAll();
+}
+
+/*!
+    @brief  Use a tiled background, repeated from the screen's top left
+            corner, and redraw everything.
+    @param  tile  w * h pixels, RAM-resident, kept (not copied).
+    @param  w     Tile width.
+    @param  h     Tile height.
+*/
+void GFXspriteLayer::setBackground(const uint16_t *tile, int16_t w, int16_t h)
+{
+    _tile = ((w > 0) && (h > 0)) ? tile : NULL;
+    _tileW = w;
+    _tileH = h;
+    invalidateAll();
+}
+
+/*!
+    @brief  Move a sprite, marking where it was and where it goes.
+    @param  i  Sprite index.
+    @param  x  New left edge.
+    @param  y  New top edge.
+*/
+void GFXspriteLayer::move(uint8_t i, int16_t x, int16_t y)
+{
+    if ((i >= _count) || ((_sprites[i].x == x) && (_sprites[i].y == y)))
+        return;
+    invalidateSprite(i);
+    _sprites[i].x = x;
+    _sprites[i].y = y;
+    invalidateSprite(i);
+}
+
+/*!
+    @brief  Change a sprite's pixels (e.g. the next animation frame), same
+            size.
+    @param  i       Sprite index.
+    @param  pixels  w * h pixels, RAM-resident.
+    @param  mask    Transparency mask (see GFXsprite), or NULL.
+*/
+void GFXspriteLayer::setFrame(uint8_t i, const uint16_t *pixels, const uint8_t *mask)
+{
+    if (i >= _count)
+        return;
+    _sprites[i].pixels = pixels;
+    _sprites[i].mask = mask;
+    invalidateSprite(i);
+}
+
+/*!
+    @brief  Show or hide a sprite.
+    @param  i        Sprite index.
+    @param  visible  true to show.
+*/
+void GFXspriteLayer::setVisible(uint8_t i, bool visible)
+{
+    if ((i >= _count) || (visible == ((_sprites[i].flags & GFX_SPRITE_VISIBLE) != 0)))
+        return;
+    invalidateSprite(i); // If hiding
+    _sprites[i].flags ^= GFX_SPRITE_VISIBLE;
+    invalidateSprite(i); // If showing
+}
+
+/*!
+    @brief  Move a sprite in front of or behind others.
+    @param  i  Sprite index.
+    @param  z  New depth, higher is in front.
+*/
+void GFXspriteLayer::setZ(uint8_t i, uint8_t z)
+{
+    if ((i >= _count) || (_sprites[i].z == z))
+        return;
+    _sprites[i].z = z;
+    sortSprites();
+    invalidateSprite(i);
+}
+
+/*!
+    @brief  Mark an area for the next update() to redraw, e.g. after
+            changing a sprite's pixels in place or drawing over the screen.
+    @param  x  Left edge.
+    @param  y  Top edge.
+    @param  w  Width.
+    @param  h  Height.
+*/
+void GFXspriteLayer::invalidate(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (!_dirty)
+        return;
+    int16_t x1 = min(x + w, _tft.width()) - 1, y1 = min(y + h, _tft.height()) - 1;
+    x = max(x, 0);
+    y = max(y, 0);
+    if ((x > x1) || (y > y1))
+        return;
+    for (uint16_t b = y / _bandRows; b <= y1 / _bandRows; b++)
+    {
+        int16_t *d = &_dirty[2 * b];
+        if (d[0] > d[1])
+        {
+            d[0] = x;
+            d[1] = x1;
+        }
+        else
+        {
+            d[0] = min(d[0], x);
+            d[1] = max(d[1], x1);
+        }
+    }
+}
+
+/*!
+    @brief  Mark the whole screen for the next update() to redraw, e.g.
+            after a rotation change.
+*/
+void GFXspriteLayer::invalidateAll(void)
+{
+    for (uint16_t b = 0; _dirty && (b < _bands); b++)
+    {
+        _dirty[2 * b] = 1;
+        _dirty[2 * b + 1] = 0;
+    }
+    invalidate(0, 0, _tft.width(), _tft.height());
+}
+
+/*!
+    @brief   Recompose and send the marked parts of the screen: for each
+             band of rows with marks, one address window spanning the
+             columns marked.
+    @return  Number of bands sent.
+*/
+uint16_t GFXspriteLayer::update(void)
+{
+    if (!_buf[0] || !_dirty || !_order)
+        return 0;
+
+    int16_t height = _tft.height();
+    uint16_t sent = 0;
+    uint8_t n = 0;
+    for (uint16_t b = 0; b < _bands; b++)
+    {
+        int16_t *d = &_dirty[2 * b], y = b * _bandRows;
+        if ((d[0] > d[1]) || (y >= height))
+            continue;
+        int16_t w = d[1] - d[0] + 1, h = min(_bandRows, height - y);
+        if (!sent++)
+            _tft.startWrite();
+        if (!_buf[1])
+            _tft.dmaWait(); // Only buffer may still be going out
+        compose(_buf[n], d[0], y, w, h);
+        _tft.dmaWait();
+        _tft.setAddrWindow(d[0], y, w, h);
+        _tft.writePixels(_buf[n], (uint32_t)w * h, false, true);
+        if (_buf[1])
+            n ^= 1;
+        d[0] = 1; // Clean
+        d[1] = 0;
+    }
+    if (sent)
+    {
+        _tft.dmaWait();
+        _tft.endWrite();
+    }
+    return sent;
+}
+
+/*!
+    @brief  Mark a visible sprite's area for redrawing.
+    @param  i  Sprite index.
+*/
+void GFXspriteLayer::invalidateSprite(uint8_t i)
+{
+    const GFXsprite &s = _sprites[i];
+    if (s.flags & GFX_SPRITE_VISIBLE)
+        invalidate(s.x, s.y, s.w, s.h);
+}
+
+/*!
+    @brief  Sort the drawing order by z (insertion sort, stable on index).
+*/
+void GFXspriteLayer::sortSprites(void)
+{
+    if (!_order)
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+        _order[i] = i;
+    for (uint8_t i = 1; i < _count; i++)
+    {
+        uint8_t s = _order[i], j = i;
+        for (; j && (_sprites[_order[j - 1]].z > _sprites[s].z); j--)
+            _order[j] = _order[j - 1];
+        _order[j] = s;
+    }
+}
+
+/*!
+    @brief  Compose part of a band: background, then sprites back to front.
+    @param  buf  w * h pixels, filled in display byte order.
+    @param  x0   Left edge.
+    @param  y0   Top edge.
+    @param  w    Width.
+    @param  h    Height.
+*/
+void GFXspriteLayer::compose(uint16_t *buf, int16_t x0, int16_t y0, int16_t w, int16_t h)
+{
+    for (int16_t j = 0; j < h; j++)
+    {
+        uint16_t *out = &buf[j * w];
+        if (_tile)
+        {
+            const uint16_t *row = &_tile[((y0 + j) % _tileH) * _tileW];
+            for (int16_t i = 0, tx = x0 % _tileW; i < w; i++)
+            {
+                putPixel(&out[i], row[tx]);
+                if (++tx == _tileW)
+                    tx = 0;
+            }
+        }
+        else
+        {
+            putPixel(&out[0], _bgColor);
+            for (int16_t i = 1; i < w; i++)
+                out[i] = out[0];
+        }
+    }
+
+    for (uint8_t k = 0; k < _count; k++)
+    {
+        const GFXsprite &s = _sprites[_order[k]];
+        if (!(s.flags & GFX_SPRITE_VISIBLE) || !s.pixels)
+            continue;
+        int16_t sx0 = max(s.x, x0), sx1 = min(s.x + s.w, x0 + w), // Overlap, exclusive ends
+            sy0 = max(s.y, y0), sy1 = min(s.y + s.h, y0 + h);
+        if ((sx0 >= sx1) || (sy0 >= sy1))
+            continue;
+        bool keyed = (s.flags & GFX_SPRITE_KEYED);
+        int16_t maskStride = (s.w + 7) / 8;
+        for (int16_t y = sy0; y < sy1; y++)
+        {
+            const uint16_t *src = &s.pixels[(y - s.y) * s.w];
+            const uint8_t *mask = s.mask ? &s.mask[(y - s.y) * maskStride] : NULL;
+            uint16_t *out = &buf[(y - y0) * w];
+            for (int16_t x = sx0; x < sx1; x++)
+            {
+                int16_t i = x - s.x;
+                if (mask && !(mask[i >> 3] & (0x80 >> (i & 7))))
+                    continue;
+                if (keyed && (src[i] == s.key))
+                    continue;
+                putPixel(&out[x - x0], src[i]);
+            }
+        }
+    }
+}
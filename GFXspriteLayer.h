@@ -0,0 +1,79 @@
+/*!
+ * @file GFXspriteLayer.h
+ *
+ * Part of Adafruit's GFX graphics library. Sprites without a framebuffer:
+ * the screen is composed a band of rows at a time (background, then the
+ * sprites in z order) into a small line buffer and streamed to the display
+ * with writePixels(). Each band remembers the columns touched since it was
+ * last sent (by sprites moving, appearing or changing frame), and only
+ * those are recomposed, so animation costs a few KB of RAM and bus traffic
+ * in proportion to what moved. With two band buffers, the next band is
+ * composed while the last one is still being sent.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXSPRITELAYER_H_
+#define _GFXSPRITELAYER_H_
+
+#include "Adafruit_SPITFT.h"
+
+// Flags for GFXsprite.flags:
+#define GFX_SPRITE_VISIBLE 0x01 ///< Sprite is drawn
+#define GFX_SPRITE_KEYED 0x02   ///< Pixels of the key color are transparent
+
+/// One sprite; set up before handing to a GFXspriteLayer, then change it
+/// through the layer's functions so the areas involved are redrawn
+typedef struct
+{
+	int16_t x, y;			///< Top left corner, at the display's rotation
+	int16_t w, h;			///< Size
+	const uint16_t *pixels; ///< w * h pixels, RAM-resident
+	const uint8_t *mask;	///< 1 bit per pixel, rows padded to bytes (as for drawRGBBitmap()); set bits are drawn. NULL if none
+	uint16_t key;			///< Transparent color, with GFX_SPRITE_KEYED
+	uint8_t z;				///< Higher is in front; equal z: higher index in front
+	uint8_t flags;			///< GFX_SPRITE_VISIBLE, GFX_SPRITE_KEYED
+} GFXsprite;
+
+/*!
+  @brief  Sprites over a solid or tiled background, composed band by band
+          and streamed to a display. The layer owns the whole screen:
+          update() redraws anything changed from background and sprites.
+*/
+class GFXspriteLayer
+{
+public:
+	GFXspriteLayer(Adafruit_SPITFT &tft, GFXsprite *sprites, uint8_t count, uint8_t bandRows = 8);
+	~GFXspriteLayer(void);
+
+	void setBackground(uint16_t color);
+	void setBackground(const uint16_t *tile, int16_t w, int16_t h);
+
+	void move(uint8_t i, int16_t x, int16_t y);
+	void setFrame(uint8_t i, const uint16_t *pixels, const uint8_t *mask = NULL);
+	void setVisible(uint8_t i, bool visible);
+	void setZ(uint8_t i, uint8_t z);
+
+	void invalidate(int16_t x, int16_t y, int16_t w, int16_t h);
+	void invalidateAll(void);
+	uint16_t update(void);
+
+private:
+	void invalidateSprite(uint8_t i);
+	void sortSprites(void);
+	void compose(uint16_t *buf, int16_t x0, int16_t y0, int16_t w, int16_t h);
+
+	Adafruit_SPITFT &_tft;
+	GFXsprite *_sprites;
+	uint8_t _count;
+	uint8_t *_order;	 ///< Sprite indices, back to front
+	uint8_t _bandRows;
+	uint16_t _bands;
+	int16_t *_dirty;	 ///< Per band: first and last column to redraw (first > last: clean)
+	uint16_t *_buf[2];   ///< Band buffers in display byte order; _buf[1] may be NULL
+	uint16_t _bgColor;
+	const uint16_t *_tile; ///< Background tile, or NULL for _bgColor
+	int16_t _tileW, _tileH;
+};
+
+#endif // _GFXSPRITELAYER_H_
@@ -0,0 +1,148 @@
+/*!
+ * @file GFXstorage.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Random-access storage for
+ * graphics data kept outside internal flash.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXstorage.h"
+
+/*!
+    @brief  GFXfileStorage constructor for an already-open file. The file
+            is not closed when the object is deleted.
+    @param  file  Open stdio FILE, readable and seekable.
+*/
+GFXfileStorage::GFXfileStorage(FILE *file) : _file(file), _owned(false)
+{
+}
+
+/*!
+    @brief  GFXfileStorage constructor that opens a file by path. Check
+            isOpen() before use.
+    @param  path  File path (e.g. "/fs/fonts/cjk24.gfx" on mbed).
+*/
+GFXfileStorage::GFXfileStorage(const char *path) : _file(fopen(path, "rb")), _owned(true)
+{
+}
+
+/*!
+    @brief  Close the file if it was opened by this object.
+*/
+GFXfileStorage::~GFXfileStorage(void)
+{
+    if (_owned && _file)
+        fclose(_file);
+}
+
+/*!
+    @brief   Query whether the file is usable.
+    @return  true if the file is open.
+*/
+bool GFXfileStorage::isOpen(void) const
+{
+    return _file != NULL;
+}
+
+/*!
+    @brief   Read a block of bytes from the file.
+    @param   buffer  Destination, at least 'size' bytes.
+    @param   addr    Byte offset in file.
+    @param   size    Number of bytes to read.
+    @return  0 on success, -1 on seek/read error or short read.
+*/
+int GFXfileStorage::read(void *buffer, uint32_t addr, uint32_t size)
+{
+    if (!_file || fseek(_file, addr, SEEK_SET))
+        return -1;
+    return (fread(buffer, 1, size, _file) == size) ? 0 : -1;
+}
+
+/*!
+    @brief   Get the length of the file.
+    @return  Size in bytes, 0 on error.
+*/
+uint32_t GFXfileStorage::size(void)
+{
+    if (!_file || fseek(_file, 0, SEEK_END))
+        return 0;
+    long len = ftell(_file);
+    return (len > 0) ? len : 0;
+}
+
+#if defined(__MBED__)
+
+/*!
+    @brief  GFXblockDeviceStorage constructor. The block device must
+            already be initialized (bd.init()), so its read size is known:
+            a bounce buffer of that size is allocated for unaligned reads.
+    @param  bd      Block device holding the data.
+    @param  offset  Byte address of the start of the data on the device.
+*/
+GFXblockDeviceStorage::GFXblockDeviceStorage(mbed::BlockDevice &bd, uint32_t offset)
+    : _bd(bd), _offset(offset), _bounce(NULL), _bounceSize(0)
+{
+    uint32_t rs = _bd.get_read_size();
+    if ((rs > 1) && (_bounce = (uint8_t *)malloc(rs)))
+        _bounceSize = rs;
+}
+
+/*!
+    @brief  Free the bounce buffer.
+*/
+GFXblockDeviceStorage::~GFXblockDeviceStorage(void)
+{
+    if (_bounce)
+        free(_bounce);
+}
+
+/*!
+    @brief   Read a block of bytes from the block device.
+    @param   buffer  Destination, at least 'size' bytes.
+    @param   addr    Byte address, relative to the storage offset.
+    @param   size    Number of bytes to read.
+    @return  0 on success, negative BlockDevice error code on failure.
+*/
+int GFXblockDeviceStorage::read(void *buffer, uint32_t addr, uint32_t size)
+{
+    uint32_t rs = _bd.get_read_size();
+    addr += _offset;
+    if ((rs <= 1) || (!(addr % rs) && !(size % rs)))
+        return _bd.read(buffer, addr, size); // Aligned, read directly
+
+    if (rs > _bounceSize)
+    { // Read size grew (device initialized late?), or out of memory before
+        uint8_t *bounce = (uint8_t *)realloc(_bounce, rs);
+        if (!bounce)
+            return -1;
+        _bounce = bounce;
+        _bounceSize = rs;
+    }
+    uint8_t *dst = (uint8_t *)buffer;
+    while (size)
+    {
+        uint32_t skip = addr % rs, n = rs - skip;
+        if (n > size)
+            n = size;
+        int err = _bd.read(_bounce, addr - skip, rs);
+        if (err)
+            return err;
+        memcpy(dst, _bounce + skip, n);
+        dst += n;
+        addr += n;
+        size -= n;
+    }
+    return 0;
+}
+
+/*!
+    @brief   Get the usable size of the block device past the offset.
+    @return  Size in bytes.
+*/
+uint32_t GFXblockDeviceStorage::size(void)
+{
+    return _bd.size() - _offset;
+}
+
+#endif // __MBED__
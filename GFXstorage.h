@@ -0,0 +1,94 @@
+/*!
+ * @file GFXstorage.h
+ *
+ * Part of Adafruit's GFX graphics library. Random-access storage for
+ * graphics data that is too large to live in internal flash (big fonts,
+ * splash screens, sprite sheets), typically kept on external SPI/QSPI
+ * flash or in a file. On a Linux host, a plain file stands in for the
+ * block device.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXSTORAGE_H_
+#define _GFXSTORAGE_H_
+
+#include "Arduino.h"
+#include <stdio.h>
+
+#if defined(__MBED__)
+#include "BlockDevice.h"
+#endif
+
+/*!
+  @brief  Abstract random-access byte source. Addresses are relative to
+          the start of the stored data.
+*/
+class GFXstorage
+{
+public:
+	virtual ~GFXstorage(void) {}
+
+	/*!
+        @brief   Read a block of bytes.
+        @param   buffer  Destination, at least 'size' bytes.
+        @param   addr    Byte address to read from.
+        @param   size    Number of bytes to read.
+        @return  0 on success, negative error code on failure (same
+                 convention as mbed BlockDevice).
+    */
+	virtual int read(void *buffer, uint32_t addr, uint32_t size) = 0;
+
+	/*!
+        @brief   Total size of the stored data.
+        @return  Size in bytes.
+    */
+	virtual uint32_t size(void) = 0;
+};
+
+/*!
+  @brief  GFXstorage backed by a stdio FILE. On mbed this may be a file on
+          a FileSystem (or a FileHandle opened with fdopen()); on Linux it
+          lets a regular file stand in for external flash.
+*/
+class GFXfileStorage : public GFXstorage
+{
+public:
+	GFXfileStorage(FILE *file);
+	GFXfileStorage(const char *path);
+	~GFXfileStorage(void);
+
+	bool isOpen(void) const;
+	int read(void *buffer, uint32_t addr, uint32_t size);
+	uint32_t size(void);
+
+private:
+	FILE *_file;
+	bool _owned; ///< If set, file was opened here and is closed on delete
+};
+
+#if defined(__MBED__)
+/*!
+  @brief  GFXstorage backed by an mbed BlockDevice (SPIFBlockDevice,
+          QSPIFBlockDevice, SDBlockDevice...). Reads that aren't aligned
+          to the device's read size are bounced through a buffer of one
+          read unit.
+*/
+class GFXblockDeviceStorage : public GFXstorage
+{
+public:
+	GFXblockDeviceStorage(mbed::BlockDevice &bd, uint32_t offset = 0);
+	~GFXblockDeviceStorage(void);
+
+	int read(void *buffer, uint32_t addr, uint32_t size);
+	uint32_t size(void);
+
+private:
+	mbed::BlockDevice &_bd;
+	uint32_t _offset; ///< Start of data on the block device
+	uint8_t *_bounce;	 ///< One read unit, for unaligned reads (NULL if not needed or out of memory)
+	uint32_t _bounceSize; ///< Bytes in _bounce
+};
+#endif // __MBED__
+
+#endif // _GFXSTORAGE_H_
@@ -0,0 +1,318 @@
+/*!
+ * @file GFXstreamFont.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Streamed fonts read from
+ * GFXstorage through an LRU glyph cache.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXstreamFont.h"
+
+/*!
+    @brief  GFXstreamFont constructor. No storage is accessed until
+            begin() is called.
+    @param  storage      Storage holding the font, starting at address 0.
+    @param  cacheGlyphs  Number of glyphs kept in RAM. Should be at least
+                         the number of distinct glyphs in a typical string
+                         so prefetch() can load a whole string at once.
+*/
+GFXstreamFont::GFXstreamFont(GFXstorage &storage, uint8_t cacheGlyphs)
+    : _storage(storage), _cache(NULL), _pool(NULL), _cacheGlyphs(cacheGlyphs ? cacheGlyphs : 1),
+      _first(0), _last(0), _maxBitmap(0), _yAdvance(0), _clock(0), _hits(0), _misses(0)
+{
+}
+
+/*!
+    @brief  Free the glyph cache.
+*/
+GFXstreamFont::~GFXstreamFont(void)
+{
+    if (_cache)
+        free(_cache);
+    if (_pool)
+        free(_pool);
+}
+
+/*!
+    @brief   Read the font header and allocate the glyph cache (cacheGlyphs
+             entries, each with room for the font's largest bitmap).
+    @return  true on success, false if the header couldn't be read, isn't a
+             streamed font, or the cache couldn't be allocated (the font
+             then has no cache, and finds no glyphs).
+*/
+bool GFXstreamFont::begin(void)
+{
+    if (_cache) // Unusable (no cache) unless this succeeds
+        free(_cache);
+    if (_pool)
+        free(_pool);
+    _cache = NULL;
+    _pool = NULL;
+
+    uint8_t hdr[GFX_STREAMFONT_HEADER_SIZE];
+    if (_storage.read(hdr, 0, sizeof(hdr)) || memcmp(hdr, "GFXE", 4))
+        return false;
+
+    _first = hdr[4] | (hdr[5] << 8);
+    _last = hdr[6] | (hdr[7] << 8);
+    _yAdvance = hdr[8];
+    _maxBitmap = hdr[10] | (hdr[11] << 8);
+    if (_last < _first)
+        return false;
+
+    CacheEntry *cache = (CacheEntry *)malloc(_cacheGlyphs * sizeof(CacheEntry));
+    uint8_t *pool = _maxBitmap ? (uint8_t *)malloc((uint32_t)_cacheGlyphs * _maxBitmap) : NULL;
+    if (!cache || (_maxBitmap && !pool))
+    { // Publish both buffers or neither
+        if (cache)
+            free(cache);
+        if (pool)
+            free(pool);
+        return false;
+    }
+    _cache = cache;
+    _pool = pool;
+    for (uint8_t i = 0; i < _cacheGlyphs; i++)
+    {
+        _cache[i].used = 0;
+        _cache[i].bitmap = _pool + (uint32_t)i * _maxBitmap;
+    }
+    _clock = _hits = _misses = 0;
+    return true;
+}
+
+/*!
+    @brief   Look up a glyph, reading it from storage on a cache miss.
+    @param   c       Character code.
+    @param   bitmap  Set to the glyph's bitmap in RAM (first byte).
+    @return  Glyph metrics (bitmapOffset is meaningless), or NULL if the
+             character isn't in the font or couldn't be read. Both
+             pointers remain valid until the next getGlyph() or prefetch().
+*/
+const GFXglyph *GFXstreamFont::getGlyph(uint16_t c, const uint8_t **bitmap)
+{
+    CacheEntry *e = find(c);
+    if (e)
+        _hits++;
+    else if (!(e = load(c, 0xFFFFFFFF)))
+        return NULL;
+    e->used = ++_clock;
+    *bitmap = e->bitmap;
+    return &e->glyph;
+}
+
+/*!
+    @brief   Load the glyphs of a string into the cache ahead of drawing,
+             so storage reads happen together rather than interleaved with
+             display transfers. Stops early (rather than evicting glyphs it
+             just loaded) if the string has more distinct glyphs than the
+             cache holds.
+    @param   str  String to be drawn (UTF-8 if the font isUnicode()).
+    @return  Number of glyphs read from storage.
+*/
+uint8_t GFXstreamFont::prefetch(const char *str)
+{
+    if (!_cache)
+        return 0;
+
+    uint32_t start = _clock;
+    uint16_t code = 0;
+    uint8_t left = 0, loaded = 0;
+    bool unicode = isUnicode();
+
+    for (uint8_t b; (b = *str++);)
+    {
+        if (unicode)
+        {
+            if (!decodeUTF8(b, &code, &left))
+                continue;
+        }
+        else
+        {
+            code = b;
+        }
+        if ((code < _first) || (code > _last))
+            continue;
+        CacheEntry *e = find(code);
+        if (!e)
+        {
+            if (!(e = load(code, start)))
+                break; // Cache full of this string's glyphs, or read error
+            loaded++;
+        }
+        e->used = ++_clock;
+    }
+    return loaded;
+}
+
+/*!
+    @brief   Get the first character code in the font.
+    @return  First character code.
+*/
+uint16_t GFXstreamFont::first(void) const
+{
+    return _first;
+}
+
+/*!
+    @brief   Get the last character code in the font.
+    @return  Last character code.
+*/
+uint16_t GFXstreamFont::last(void) const
+{
+    return _last;
+}
+
+/*!
+    @brief   Get the newline distance of the font.
+    @return  Y advance in pixels (unscaled).
+*/
+uint8_t GFXstreamFont::yAdvance(void) const
+{
+    return _yAdvance;
+}
+
+/*!
+    @brief   Whether text for this font is UTF-8 encoded. True for fonts
+             with character codes beyond 0xFF; smaller fonts take one byte
+             per character like GFXfont.
+    @return  true if strings are decoded as UTF-8.
+*/
+bool GFXstreamFont::isUnicode(void) const
+{
+    return _last > 0xFF;
+}
+
+/*!
+    @brief   Number of getGlyph() calls satisfied from the cache.
+    @return  Hit count since begin().
+*/
+uint32_t GFXstreamFont::cacheHits(void) const
+{
+    return _hits;
+}
+
+/*!
+    @brief   Number of glyphs read from storage.
+    @return  Miss count since begin().
+*/
+uint32_t GFXstreamFont::cacheMisses(void) const
+{
+    return _misses;
+}
+
+/*!
+    @brief   Incremental UTF-8 decoder (Basic Multilingual Plane only;
+             4-byte sequences are dropped).
+    @param   b     Next byte of text.
+    @param   code  Code point being assembled; holds the result when the
+                   function returns true.
+    @param   left  Continuation bytes still expected, 0 to start.
+    @return  true if 'code' now holds a complete code point.
+*/
+bool GFXstreamFont::decodeUTF8(uint8_t b, uint16_t *code, uint8_t *left)
+{
+    if (b < 0x80)
+    { // ASCII
+        *left = 0;
+        *code = b;
+        return true;
+    }
+    if ((b & 0xC0) == 0x80)
+    { // Continuation byte
+        if (!*left)
+            return false;
+        *code = (*code << 6) | (b & 0x3F);
+        return !--*left;
+    }
+    if ((b & 0xE0) == 0xC0)
+    {
+        *code = b & 0x1F;
+        *left = 1;
+    }
+    else if ((b & 0xF0) == 0xE0)
+    {
+        *code = b & 0x0F;
+        *left = 2;
+    }
+    else
+    {
+        *left = 0;
+    }
+    return false;
+}
+
+/*!
+    @brief   Find a glyph in the cache.
+    @param   c  Character code.
+    @return  Cache entry, or NULL if not cached.
+*/
+GFXstreamFont::CacheEntry *GFXstreamFont::find(uint16_t c)
+{
+    if (_cache)
+    {
+        for (uint8_t i = 0; i < _cacheGlyphs; i++)
+        {
+            if (_cache[i].used && (_cache[i].code == c))
+                return &_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/*!
+    @brief   Read a glyph from storage into the least recently used cache
+             entry.
+    @param   c     Character code.
+    @param   keep  Entries used more recently than this stamp are not
+                   evicted (prefetch() protects the string being loaded).
+    @return  Filled cache entry, or NULL if the character isn't in the
+             font, storage read failed or no entry may be evicted.
+*/
+GFXstreamFont::CacheEntry *GFXstreamFont::load(uint16_t c, uint32_t keep)
+{
+    if (!_cache || (c < _first) || (c > _last))
+        return NULL;
+
+    CacheEntry *victim = &_cache[0];
+    for (uint8_t i = 1; (i < _cacheGlyphs) && victim->used; i++)
+    {
+        if (_cache[i].used < victim->used)
+            victim = &_cache[i];
+    }
+    if (victim->used > keep)
+        return NULL;
+
+    uint8_t rec[GFX_STREAMFONT_GLYPH_SIZE];
+    uint32_t glyphs = (uint32_t)(_last - _first + 1),
+             addr = GFX_STREAMFONT_HEADER_SIZE + (uint32_t)(c - _first) * GFX_STREAMFONT_GLYPH_SIZE;
+    victim->used = 0; // Entry is invalid until fully loaded
+    if (_storage.read(rec, addr, sizeof(rec)))
+        return NULL;
+
+    GFXglyphExt g;
+    g.bitmapOffset = rec[0] | ((uint32_t)rec[1] << 8) | ((uint32_t)rec[2] << 16) | ((uint32_t)rec[3] << 24);
+    g.width = rec[4];
+    g.height = rec[5];
+    g.xAdvance = rec[6];
+    g.xOffset = (int8_t)rec[7];
+    g.yOffset = (int8_t)rec[8];
+
+    uint16_t bytes = ((uint16_t)g.width * g.height + 7) / 8;
+    if (bytes > _maxBitmap)
+        return NULL; // Corrupt font
+    if (bytes && _storage.read(victim->bitmap, GFX_STREAMFONT_HEADER_SIZE + glyphs * GFX_STREAMFONT_GLYPH_SIZE + g.bitmapOffset, bytes))
+        return NULL;
+
+    victim->code = c;
+    victim->glyph.bitmapOffset = 0;
+    victim->glyph.width = g.width;
+    victim->glyph.height = g.height;
+    victim->glyph.xAdvance = g.xAdvance;
+    victim->glyph.xOffset = g.xOffset;
+    victim->glyph.yOffset = g.yOffset;
+    victim->used = ++_clock;
+    _misses++;
+    return victim;
+}
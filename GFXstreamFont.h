@@ -0,0 +1,87 @@
+/*!
+ * @file GFXstreamFont.h
+ *
+ * Part of Adafruit's GFX graphics library. Streamed fonts: fonts whose
+ * glyph table and bitmaps live in a GFXstorage (external flash, a file)
+ * rather than in PROGMEM, read on demand through a small LRU glyph cache
+ * in RAM. Glyph bitmap offsets are 32-bit, so a font's bitmaps are not
+ * limited to 64 KB, and character codes are 16-bit so large CJK fonts can
+ * be used (text is then expected to be UTF-8).
+ *
+ * Stored font layout (all multi-byte values little-endian):
+ *
+ *   offset 0   'G','F','X','E'  magic
+ *          4   uint16_t first   first character code
+ *          6   uint16_t last    last character code
+ *          8   uint8_t  yAdvance newline distance
+ *          9   uint8_t  reserved (0)
+ *         10   uint16_t maxBitmap size in bytes of the largest glyph bitmap
+ *         12   (last - first + 1) glyph records of GFX_STREAMFONT_GLYPH_SIZE
+ *              bytes each, fields in GFXglyphExt order (uint32_t
+ *              bitmapOffset, then width, height, xAdvance, xOffset,
+ *              yOffset as single bytes)
+ *          .   glyph bitmaps, concatenated; bitmapOffset is relative to
+ *              the first byte after the glyph records
+ *
+ * Bitmaps use the same packing as GFXfont (rows not padded, MSB first).
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXSTREAMFONT_H_
+#define _GFXSTREAMFONT_H_
+
+#include "Arduino.h"
+#include "gfxfont.h"
+#include "GFXstorage.h"
+
+#define GFX_STREAMFONT_HEADER_SIZE 12 ///< Bytes before the glyph records
+#define GFX_STREAMFONT_GLYPH_SIZE 9   ///< Bytes per stored glyph record
+
+/*!
+  @brief  A font read from GFXstorage through an LRU glyph cache. Pass to
+          Adafruit_GFX::setStreamFont().
+*/
+class GFXstreamFont
+{
+public:
+	GFXstreamFont(GFXstorage &storage, uint8_t cacheGlyphs = 16);
+	~GFXstreamFont(void);
+
+	bool begin(void);
+	const GFXglyph *getGlyph(uint16_t c, const uint8_t **bitmap);
+	uint8_t prefetch(const char *str);
+
+	uint16_t first(void) const;
+	uint16_t last(void) const;
+	uint8_t yAdvance(void) const;
+	bool isUnicode(void) const;
+	uint32_t cacheHits(void) const;
+	uint32_t cacheMisses(void) const;
+
+	static bool decodeUTF8(uint8_t b, uint16_t *code, uint8_t *left);
+
+private:
+	/// One cached glyph: metrics plus a pointer into the bitmap pool
+	struct CacheEntry
+	{
+		uint32_t used;   ///< LRU stamp, 0 if entry is empty
+		uint16_t code;   ///< Character code held
+		GFXglyph glyph;  ///< Metrics (bitmapOffset unused)
+		uint8_t *bitmap; ///< This entry's slot in the bitmap pool
+	};
+
+	CacheEntry *find(uint16_t c);
+	CacheEntry *load(uint16_t c, uint32_t keep);
+
+	GFXstorage &_storage;
+	CacheEntry *_cache;  ///< cacheGlyphs entries
+	uint8_t *_pool;      ///< cacheGlyphs * _maxBitmap bytes
+	uint8_t _cacheGlyphs;
+	uint16_t _first, _last, _maxBitmap;
+	uint8_t _yAdvance;
+	uint32_t _clock;     ///< Incremented on every cache access
+	uint32_t _hits, _misses;
+};
+
+#endif // _GFXSTREAMFONT_H_
@@ -0,0 +1,267 @@
+/*!
+ * @file GFXstripChart.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Sweeping strip charts.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXstripChart.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief  GFXstripChart constructor. Nothing is drawn until clear() (or
+            the first sample).
+    @param  gfx       Display (or canvas) to draw on.
+    @param  x         Left edge of the chart.
+    @param  y         Top edge of the chart.
+    @param  w         Width: one column, and one sample kept, per pixel.
+    @param  h         Height.
+    @param  minValue  Sample value plotted on the bottom row.
+    @param  maxValue  Sample value plotted on the top row (values outside
+                      the range are clamped).
+    @param  color     Trace color.
+    @param  bg        Background color.
+*/
+GFXstripChart::GFXstripChart(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, int16_t minValue, int16_t maxValue, uint16_t color, uint16_t bg)
+    : _gfx(gfx), _x(x), _y(y), _w(max(w, 1)), _h(max(h, 1)), _color(color), _bg(bg), _col(0), _count(0), _lastRow(0)
+{
+    _min = minValue;
+    _max = (maxValue > minValue) ? maxValue : minValue + 1;
+    _values = (int16_t *)malloc(_w * sizeof(int16_t));
+    _runs = (Run *)malloc(_w * sizeof(Run));
+    if (!_values || !_runs)
+    { // Plot without history (each column erased whole)
+        free(_values);
+        free(_runs);
+        _values = NULL;
+        _runs = NULL;
+    }
+    for (int16_t i = 0; _runs && (i < _w); i++)
+    {
+        _runs[i].top = 1;
+        _runs[i].bottom = 0;
+    }
+}
+
+/*!
+    @brief  Free the sample history.
+*/
+GFXstripChart::~GFXstripChart(void)
+{
+    if (_values)
+        free(_values);
+    if (_runs)
+        free(_runs);
+}
+
+/*!
+    @brief  Plot one sample in the next column, in its own transaction.
+    @param  value  Sample value.
+*/
+void GFXstripChart::add(int16_t value)
+{
+    _gfx.startWrite();
+    plot(value);
+    _gfx.endWrite();
+}
+
+/*!
+    @brief  Plot a batch of samples in the next columns, in one
+            transaction.
+    @param  values  Sample values, oldest first.
+    @param  n       Number of samples.
+*/
+void GFXstripChart::add(const int16_t *values, uint16_t n)
+{
+    _gfx.startWrite();
+    while (n--)
+        plot(*values++);
+    _gfx.endWrite();
+}
+
+/*!
+    @brief  Fill the chart with the background color and forget all
+            samples; the next sample goes in the leftmost column.
+*/
+void GFXstripChart::clear(void)
+{
+    _gfx.fillRect(_x, _y, _w, _h, _bg);
+    for (int16_t i = 0; _runs && (i < _w); i++)
+    {
+        _runs[i].top = 1;
+        _runs[i].bottom = 0;
+    }
+    _col = 0;
+    _count = 0;
+}
+
+/*!
+    @brief  Redraw the chart from the samples held, e.g. after the screen
+            was overdrawn or the range or colors changed. The oldest
+            sample, whose predecessor is gone, is plotted as a single
+            pixel.
+*/
+void GFXstripChart::redraw(void)
+{
+    _gfx.startWrite();
+    _gfx.writeFillRect(_x, _y, _w, _h, _bg);
+    if (_runs)
+    {
+        for (int16_t i = 0; i < _w; i++)
+        {
+            _runs[i].top = 1;
+            _runs[i].bottom = 0;
+        }
+        for (uint16_t k = 0; k < _count; k++)
+        {
+            int16_t c = (_col - _count + k + _w) % _w;
+            int16_t r = row(_values[c]);
+            Run &run = _runs[c];
+            run.top = run.bottom = r;
+            if (k && (_lastRow < r))
+                run.top = _lastRow + 1;
+            else if (k && (_lastRow > r))
+                run.bottom = _lastRow - 1;
+            vline(_x + c, run.top, run.bottom, _color);
+            _lastRow = r;
+        }
+    }
+    else
+    {
+        _count = 0; // Nothing to redraw, start the trace afresh
+    }
+    _gfx.endWrite();
+}
+
+/*!
+    @brief  Change the range of sample values plotted, and redraw.
+    @param  minValue  Sample value plotted on the bottom row.
+    @param  maxValue  Sample value plotted on the top row.
+*/
+void GFXstripChart::setRange(int16_t minValue, int16_t maxValue)
+{
+    _min = minValue;
+    _max = (maxValue > minValue) ? maxValue : minValue + 1;
+    redraw();
+}
+
+/*!
+    @brief  Change the colors, and redraw.
+    @param  color  Trace color.
+    @param  bg     Background color.
+*/
+void GFXstripChart::setColors(uint16_t color, uint16_t bg)
+{
+    _color = color;
+    _bg = bg;
+    redraw();
+}
+
+/*!
+    @brief   Get the column the next sample is plotted in.
+    @return  Column, 0 = leftmost.
+*/
+int16_t GFXstripChart::column(void) const
+{
+    return _col;
+}
+
+/*!
+    @brief   Get the number of samples held (at most the chart width; 0 if
+             the history couldn't be allocated).
+    @return  Number of samples.
+*/
+uint16_t GFXstripChart::samples(void) const
+{
+    return _values ? _count : 0;
+}
+
+/*!
+    @brief   Get a sample held.
+    @param   age  0 for the newest sample, 1 for the one before, etc.
+    @return  Sample value (0 if not held).
+*/
+int16_t GFXstripChart::value(uint16_t age) const
+{
+    if (age >= samples())
+        return 0;
+    return _values[(_col - 1 - (int16_t)age + 2 * _w) % _w];
+}
+
+/*!
+    @brief   Map a sample value to a display row.
+    @param   value  Sample value.
+    @return  Row, clamped to the chart.
+*/
+int16_t GFXstripChart::row(int16_t value) const
+{
+    value = min(max(value, _min), _max);
+    return _y + (int32_t)(_max - value) * (_h - 1) / ((int32_t)_max - _min);
+}
+
+/*!
+    @brief  Plot one sample in the next column: erase the pixels of the
+            previous sweep's trace there that the new segment doesn't
+            cover, then draw the new segment's pixels that weren't already
+            trace. Not self-contained; should follow startWrite().
+    @param  value  Sample value.
+*/
+void GFXstripChart::plot(int16_t value)
+{
+    int16_t r = row(value), top = r, bottom = r, x = _x + _col;
+    if (_count && (_lastRow < r))
+        top = _lastRow + 1; // Join the previous sample
+    else if (_count && (_lastRow > r))
+        bottom = _lastRow - 1;
+
+    if (_runs)
+    {
+        Run &old = _runs[_col];
+        if (old.top <= old.bottom)
+        {
+            vline(x, old.top, min(old.bottom, top - 1), _bg);
+            vline(x, max(old.top, bottom + 1), old.bottom, _bg);
+            vline(x, top, min(bottom, old.top - 1), _color);
+            vline(x, max(top, old.bottom + 1), bottom, _color);
+        }
+        else
+        {
+            vline(x, top, bottom, _color);
+        }
+        old.top = top;
+        old.bottom = bottom;
+        _values[_col] = value;
+        if (_count < _w)
+            _count++;
+    }
+    else
+    {
+        vline(x, _y, _y + _h - 1, _bg);
+        vline(x, top, bottom, _color);
+        _count = 1; // _lastRow valid
+    }
+    _lastRow = r;
+    if (++_col >= _w)
+        _col = 0;
+}
+
+/*!
+    @brief  Draw a vertical run of pixels, if not empty. Not
+            self-contained; should follow startWrite().
+    @param  x       Column.
+    @param  top     Top row.
+    @param  bottom  Bottom row (inclusive, less than top: nothing drawn).
+    @param  color   16-bit 5-6-5 color.
+*/
+void GFXstripChart::vline(int16_t x, int16_t top, int16_t bottom, uint16_t color)
+{
+    if (top <= bottom)
+        _gfx.writeFastVLine(x, top, bottom - top + 1, color);
+}
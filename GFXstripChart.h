@@ -0,0 +1,64 @@
+/*!
+ * @file GFXstripChart.h
+ *
+ * Part of Adafruit's GFX graphics library. Strip charts: a live trace
+ * plotted left to right, oscilloscope style. Each new sample takes the next
+ * column; the trace drawn there on the previous sweep is erased and the new
+ * segment drawn as one vertical run from the previous sample, sending only
+ * the pixels that change, so a chart updates without redrawing the plot or
+ * clearing it column by column with fillRect().
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXSTRIPCHART_H_
+#define _GFXSTRIPCHART_H_
+
+#include "Adafruit_GFX.h"
+
+/*!
+  @brief  Sweeping strip chart of the last w samples in a w x h area of a
+          display. The area belongs to the chart: anything else drawn
+          there may be left in place or erased with the background color.
+*/
+class GFXstripChart
+{
+public:
+	GFXstripChart(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, int16_t minValue, int16_t maxValue, uint16_t color, uint16_t bg);
+	~GFXstripChart(void);
+
+	void add(int16_t value);
+	void add(const int16_t *values, uint16_t n);
+	void clear(void);
+	void redraw(void);
+
+	void setRange(int16_t minValue, int16_t maxValue);
+	void setColors(uint16_t color, uint16_t bg);
+
+	int16_t column(void) const;
+	uint16_t samples(void) const;
+	int16_t value(uint16_t age) const;
+
+private:
+	/// Rows of the trace in one column, inclusive (top > bottom: none)
+	struct Run
+	{
+		int16_t top, bottom;
+	};
+
+	int16_t row(int16_t value) const;
+	void plot(int16_t value);
+	void vline(int16_t x, int16_t top, int16_t bottom, uint16_t color);
+
+	Adafruit_GFX &_gfx;
+	int16_t _x, _y, _w, _h;
+	int16_t _min, _max;
+	uint16_t _color, _bg;
+	int16_t *_values;  ///< w samples by column, NULL if out of memory
+	Run *_runs;		   ///< w runs on screen, by column
+	int16_t _col;	  ///< Column the next sample goes in
+	uint16_t _count;   ///< Samples held, up to w
+	int16_t _lastRow;  ///< Row of the previous sample, if _count
+};
+
+#endif // _GFXSTRIPCHART_H_
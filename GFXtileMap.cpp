@@ -0,0 +1,277 @@
+/*!
+ * @file GFXtileMap.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Scrolling tile maps.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXtileMap.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief   Wrap a map position into the map.
+    @param   v  Position in pixels, any value.
+    @param   n  Map size in pixels.
+    @return  Position from 0 to n - 1.
+*/
+static inline int32_t wrap(int32_t v, int32_t n)
+{
+    v %= n;
+    return (v < 0) ? v + n : v;
+}
+
+/*!
+    @brief  GFXtileMap constructor. Nothing is drawn until draw(); the view
+            starts at the map's top left corner.
+    @param  gfx        Display (or canvas) to draw on.
+    @param  x          Left edge of the view.
+    @param  y          Top edge of the view.
+    @param  w          View width.
+    @param  h          View height.
+    @param  atlas      Tile images, side by side in rows of atlasCols tiles
+                       (tile i at column i % atlasCols, row i / atlasCols),
+                       RAM-resident, kept (not copied).
+    @param  atlasCols  Tiles across the atlas.
+    @param  tileW      Tile width, e.g. 8 or 16.
+    @param  tileH      Tile height.
+    @param  map        Tile index per map cell, row by row, kept (not
+                       copied).
+    @param  mapCols    Map width in tiles.
+    @param  mapRows    Map height in tiles.
+*/
+GFXtileMap::GFXtileMap(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t *atlas, uint8_t atlasCols, uint8_t tileW, uint8_t tileH, uint8_t *map, uint16_t mapCols, uint16_t mapRows)
+    : _gfx(gfx), _x(x), _y(y), _w(max(w, 1)), _h(max(h, 1)), _atlas(atlas), _atlasCols(max(atlasCols, 1)), _tileW(max(tileW, 1)), _tileH(max(tileH, 1)),
+      _map(map), _mapCols(max(mapCols, 1)), _mapRows(max(mapRows, 1)), _sx(0), _sy(0), _phaseX(-1), _phaseY(-1)
+{
+    _mapW = (int32_t)_mapCols * _tileW;
+    _mapH = (int32_t)_mapRows * _tileH;
+    _cellCols = (_w + _tileW - 1) / _tileW + 1; // A partial cell each side
+    _cellRows = (_h + _tileH - 1) / _tileH + 1;
+    _cells = (uint8_t *)malloc(_cellCols * _cellRows);
+}
+
+/*!
+    @brief  Free the screen cell record.
+*/
+GFXtileMap::~GFXtileMap(void)
+{
+    if (_cells)
+        free(_cells);
+}
+
+/*!
+    @brief  Draw the whole view, e.g. at first or after the screen was
+            overdrawn.
+*/
+void GFXtileMap::draw(void)
+{
+    update(true, true);
+}
+
+/*!
+    @brief  Redraw the screen cells whose tile changed, e.g. after changing
+            several map cells in place or swapping tile indices.
+*/
+void GFXtileMap::refresh(void)
+{
+    update(false, true);
+}
+
+/*!
+    @brief  Move the view to a map position; nothing is drawn before
+            draw(). Where the display can move its own pixels (see
+            Adafruit_GFX::scrollRect()) and the move is smaller than the
+            view, only the rows and columns uncovered are drawn;
+            otherwise the cells whose tile changed are redrawn (after a
+            move by whole tiles, only those showing a different tile than
+            before).
+    @param  x  Map pixel to show at the view's left edge (wraps).
+    @param  y  Map pixel to show at the view's top edge (wraps).
+*/
+void GFXtileMap::scrollTo(int32_t x, int32_t y)
+{
+    x = wrap(x, _mapW);
+    y = wrap(y, _mapH);
+    int32_t dx = x - _sx, dy = y - _sy; // Shortest way round
+    if (dx > _mapW / 2)
+        dx -= _mapW;
+    else if (dx < -_mapW / 2)
+        dx += _mapW;
+    if (dy > _mapH / 2)
+        dy -= _mapH;
+    else if (dy < -_mapH / 2)
+        dy += _mapH;
+    if (!dx && !dy)
+        return;
+
+    _sx = x;
+    _sy = y;
+    if (_phaseX < 0)
+        return; // Nothing shown yet, draw() sends the whole view
+    if ((dx > -_w) && (dx < _w) && (dy > -_h) && (dy < _h) && _gfx.scrollRect(_x, _y, _w, _h, -dx, -dy))
+    {
+        int16_t top = (dy < 0) ? -dy : 0, bottom = _h - ((dy > 0) ? dy : 0); // Rows moved
+        if (dy < 0)
+            drawArea(0, 0, _w, -dy);
+        else if (dy > 0)
+            drawArea(0, bottom, _w, dy);
+        if (dx < 0)
+            drawArea(0, top, -dx, bottom - top);
+        else if (dx > 0)
+            drawArea(_w - dx, top, dx, bottom - top);
+        update(false, false);
+    }
+    else
+    {
+        update(false, true);
+    }
+}
+
+/*!
+    @brief  Move the view by a distance (see scrollTo()).
+    @param  dx  Pixels to move right (negative: left).
+    @param  dy  Pixels to move down (negative: up).
+*/
+void GFXtileMap::scrollBy(int16_t dx, int16_t dy)
+{
+    scrollTo(_sx + dx, _sy + dy);
+}
+
+/*!
+    @brief   Get the map pixel shown at the view's left edge.
+    @return  Position, 0 to map width - 1.
+*/
+int32_t GFXtileMap::scrollX(void) const
+{
+    return _sx;
+}
+
+/*!
+    @brief   Get the map pixel shown at the view's top edge.
+    @return  Position, 0 to map height - 1.
+*/
+int32_t GFXtileMap::scrollY(void) const
+{
+    return _sy;
+}
+
+/*!
+    @brief  Change one map cell, redrawing it where it shows.
+    @param  col    Map column.
+    @param  row    Map row.
+    @param  index  Tile index.
+*/
+void GFXtileMap::setTile(uint16_t col, uint16_t row, uint8_t index)
+{
+    if ((col >= _mapCols) || (row >= _mapRows) || (_map[row * _mapCols + col] == index))
+        return;
+    _map[row * _mapCols + col] = index;
+    refresh();
+}
+
+/*!
+    @brief   Get one map cell.
+    @param   col  Map column.
+    @param   row  Map row.
+    @return  Tile index (0 outside the map).
+*/
+uint8_t GFXtileMap::tile(uint16_t col, uint16_t row) const
+{
+    if ((col >= _mapCols) || (row >= _mapRows))
+        return 0;
+    return _map[row * _mapCols + col];
+}
+
+/*!
+    @brief  Bring the screen cells up to date with the map, and note the
+            tile each shows. A change of position within a tile (the
+            cells no longer line up with those noted) draws every cell;
+            before the first draw(), only 'all' draws anything.
+    @param  all   true to draw every cell.
+    @param  send  false to only note what the screen already shows.
+*/
+void GFXtileMap::update(bool all, bool send)
+{
+    int16_t px = _sx % _tileW, py = _sy % _tileH;
+    if ((_phaseX < 0) && !all)
+        return; // Nothing shown yet, draw() sends the whole view
+    if (!_cells)
+    {
+        if (send)
+            drawArea(0, 0, _w, _h);
+        _phaseX = px;
+        _phaseY = py;
+        return;
+    }
+
+    all = all || (px != _phaseX) || (py != _phaseY);
+    uint16_t col0 = _sx / _tileW, row0 = _sy / _tileH;
+    uint8_t *cell = _cells;
+    for (uint16_t j = 0; j < _cellRows; j++)
+    {
+        int16_t top = j * _tileH - py, y0 = max(top, 0), y1 = min(top + _tileH, _h);
+        const uint8_t *row = &_map[((row0 + j) % _mapRows) * _mapCols];
+        for (uint16_t i = 0; i < _cellCols; i++, cell++)
+        {
+            int16_t left = i * _tileW - px, x0 = max(left, 0), x1 = min(left + _tileW, _w);
+            if ((x0 >= x1) || (y0 >= y1))
+                continue; // Past the view's edge
+            uint8_t index = row[(col0 + i) % _mapCols];
+            if (send && (all || (*cell != index)))
+                piece(_x + x0, _y + y0, index, x0 - left, y0 - top, x1 - x0, y1 - y0);
+            *cell = index;
+        }
+    }
+    _phaseX = px;
+    _phaseY = py;
+}
+
+/*!
+    @brief  Draw part of the view from the map, a tile (or part of one) at
+            a time.
+    @param  vx  Left edge, relative to the view.
+    @param  vy  Top edge, relative to the view.
+    @param  vw  Width.
+    @param  vh  Height.
+*/
+void GFXtileMap::drawArea(int16_t vx, int16_t vy, int16_t vw, int16_t vh)
+{
+    for (int16_t j = vy; j < vy + vh;)
+    {
+        int32_t my = (_sy + j) % _mapH;
+        int16_t ty = my % _tileH, n = min(_tileH - ty, vy + vh - j);
+        const uint8_t *row = &_map[(my / _tileH) * _mapCols];
+        for (int16_t i = vx; i < vx + vw;)
+        {
+            int32_t mx = (_sx + i) % _mapW;
+            int16_t tx = mx % _tileW, m = min(_tileW - tx, vx + vw - i);
+            piece(_x + i, _y + j, row[mx / _tileW], tx, ty, m, n);
+            i += m;
+        }
+        j += n;
+    }
+}
+
+/*!
+    @brief  Draw a rectangle of one tile from the atlas.
+    @param  x      Display x of the rectangle.
+    @param  y      Display y of the rectangle.
+    @param  index  Tile index.
+    @param  tx     Left edge within the tile.
+    @param  ty     Top edge within the tile.
+    @param  w      Width.
+    @param  h      Height.
+*/
+void GFXtileMap::piece(int16_t x, int16_t y, uint8_t index, int16_t tx, int16_t ty, int16_t w, int16_t h)
+{
+    int16_t stride = _atlasCols * _tileW;
+    uint16_t *src = &_atlas[((int32_t)(index / _atlasCols) * _tileH + ty) * stride + (index % _atlasCols) * _tileW + tx];
+    _gfx.drawRGBSubBitmap(x, y, src, stride, w, h);
+}
@@ -0,0 +1,59 @@
+/*!
+ * @file GFXtileMap.h
+ *
+ * Part of Adafruit's GFX graphics library. Tile maps: a scrolling
+ * background (map, level) built from a grid of tile indices and an atlas
+ * holding the tile images. The map remembers which tile each screen cell
+ * shows, so a redraw sends only the cells whose tile changed; and where
+ * the display can move its own pixels (canvases, or a driver with hardware
+ * scrolling, see Adafruit_GFX::scrollRect()), a scroll moves the view and
+ * draws only the strip of tiles it uncovers.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXTILEMAP_H_
+#define _GFXTILEMAP_H_
+
+#include "Adafruit_GFX.h"
+
+/*!
+  @brief  View of a tile map in a w x h area of a display. The map repeats
+          in both directions, so scrolling past an edge wraps around.
+*/
+class GFXtileMap
+{
+public:
+	GFXtileMap(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t *atlas, uint8_t atlasCols, uint8_t tileW, uint8_t tileH, uint8_t *map, uint16_t mapCols, uint16_t mapRows);
+	~GFXtileMap(void);
+
+	void draw(void);
+	void refresh(void);
+	void scrollTo(int32_t x, int32_t y);
+	void scrollBy(int16_t dx, int16_t dy);
+	int32_t scrollX(void) const;
+	int32_t scrollY(void) const;
+
+	void setTile(uint16_t col, uint16_t row, uint8_t index);
+	uint8_t tile(uint16_t col, uint16_t row) const;
+
+private:
+	void update(bool all, bool send);
+	void drawArea(int16_t vx, int16_t vy, int16_t vw, int16_t vh);
+	void piece(int16_t x, int16_t y, uint8_t index, int16_t tx, int16_t ty, int16_t w, int16_t h);
+
+	Adafruit_GFX &_gfx;
+	int16_t _x, _y, _w, _h;
+	uint16_t *_atlas;
+	uint8_t _atlasCols;
+	uint8_t _tileW, _tileH;
+	uint8_t *_map;
+	uint16_t _mapCols, _mapRows;
+	int32_t _mapW, _mapH; ///< Map size in pixels
+	int32_t _sx, _sy;	 ///< Map pixel at the view's top left corner
+	uint8_t *_cells;	  ///< Tile shown per screen cell, NULL if out of memory
+	uint16_t _cellCols, _cellRows;
+	int16_t _phaseX, _phaseY; ///< Scroll position within a tile when _cells was filled, -1: never
+};
+
+#endif // _GFXTILEMAP_H_
@@ -0,0 +1,302 @@
+/*!
+ * @file GFXupdateScheduler.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Priority-ordered flushing of
+ * invalidated canvas regions.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXupdateScheduler.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief  GFXupdateScheduler constructor.
+    @param  canvas      Canvas holding the screen contents (rotation 0).
+    @param  display     Display the canvas is copied to.
+    @param  maxRegions  Pending regions tracked; when full, two regions of
+                        the least urgent class that has two are merged
+                        (the pair whose union grows least). Only with fewer
+                        regions than classes in use are two classes merged,
+                        the two least urgent.
+*/
+GFXupdateScheduler::GFXupdateScheduler(GFXcanvas16 &canvas, Adafruit_GFX &display, uint8_t maxRegions)
+    : _canvas(canvas), _display(display), _maxRegions(maxRegions ? maxRegions : 1), _count(0)
+{
+    _regions = (Region *)malloc(_maxRegions * sizeof(Region));
+    resetStats();
+}
+
+/*!
+    @brief  Free the region list.
+*/
+GFXupdateScheduler::~GFXupdateScheduler(void)
+{
+    if (_regions)
+        free(_regions);
+}
+
+/*!
+    @brief   Mark a changed area of the canvas for copying to the display.
+             Pending regions of the same priority class that overlap it
+             are merged into one (taking the earlier deadline); regions of
+             different classes are kept apart, so an urgent area is never
+             held up by a neighbouring slow one.
+    @param   x           Left edge of changed area.
+    @param   y           Top edge of changed area.
+    @param   w           Width of changed area.
+    @param   h           Height of changed area.
+    @param   priority    Priority class, 0 (most urgent) to
+                         GFX_UPDATE_PRIORITIES - 1.
+    @param   deadlineUs  If nonzero, the area should reach the display
+                         within this many microseconds; regions of a class
+                         with deadlines go first, earliest first.
+    @return  true if queued, false if the region list couldn't be allocated
+             (the area is then copied immediately).
+*/
+bool GFXupdateScheduler::invalidate(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t priority, uint32_t deadlineUs)
+{
+    Region r;
+    r.x0 = max(x, 0);
+    r.y0 = max(y, 0);
+    r.x1 = min(x + w, min(_canvas.width(), _display.width())) - 1;
+    r.y1 = min(y + h, min(_canvas.height(), _display.height())) - 1;
+    if ((r.x1 < r.x0) || (r.y1 < r.y0))
+        return true; // Nothing visible
+    r.priority = min(priority, GFX_UPDATE_PRIORITIES - 1);
+    r.invalidated = gfxMicros();
+    r.hasDeadline = (deadlineUs != 0);
+    r.deadline = r.invalidated + deadlineUs;
+
+    if (!_regions)
+    {
+        _display.drawRGBSubBitmap(r.x0, r.y0, _canvas.getBuffer() + r.y0 * _canvas.width() + r.x0, _canvas.width(), r.x1 - r.x0 + 1, r.y1 - r.y0 + 1);
+        return false;
+    }
+
+    for (;;)
+    {
+        uint8_t i;
+        for (i = 0; i < _count; i++)
+        {
+            Region *p = &_regions[i];
+            if ((p->priority == r.priority) && (p->x0 <= r.x1) && (r.x0 <= p->x1) && (p->y0 <= r.y1) && (r.y0 <= p->y1))
+                break; // Overlapping, same class
+        }
+        if (i < _count)
+        {
+            merge(&r, &_regions[i]);
+            _regions[i] = _regions[--_count];
+            continue;
+        }
+        if (_count < _maxRegions)
+            break; // No merges left to do, room to add
+
+        // List full: merge the cheapest pair of the least urgent class that
+        // has two regions (r counting as region _count)
+        uint8_t a = 0, b = 0;
+        if (!cheapestPair(&r, &a, &b))
+        { // No class has two (short list): merge the two least urgent
+            int16_t first = -1, second = -1;
+            for (uint16_t j = 0; j <= _count; j++)
+            {
+                uint8_t pri = ((j == _count) ? r : _regions[j]).priority;
+                if ((first < 0) || (pri >= ((first == _count) ? r : _regions[first]).priority))
+                {
+                    second = first;
+                    first = j;
+                }
+                else if ((second < 0) || (pri >= ((second == _count) ? r : _regions[second]).priority))
+                {
+                    second = j;
+                }
+            }
+            a = first;
+            b = second;
+        }
+        if (a > b)
+        {
+            uint8_t t = a;
+            a = b;
+            b = t;
+        }
+        if (b == _count)
+            merge(&r, &_regions[a]); // r grew, look for overlaps again
+        else
+            merge(&_regions[b], &_regions[a]);
+        _regions[a] = _regions[--_count];
+    }
+    _regions[_count++] = r;
+    return true;
+}
+
+/*!
+    @brief   Copy the most urgent pending region to the display. Regions are
+             never split, so this is the preemption point: anything
+             invalidated meanwhile is considered at the next call.
+    @return  true if more regions are pending.
+*/
+bool GFXupdateScheduler::flushNext(void)
+{
+    if (!_count)
+        return false;
+
+    uint32_t now = gfxMicros();
+    uint8_t best = 0;
+    for (uint8_t i = 1; i < _count; i++)
+    {
+        if (before(&_regions[i], &_regions[best], now))
+            best = i;
+    }
+    Region r = _regions[best];
+    _regions[best] = _regions[--_count];
+
+    _display.drawRGBSubBitmap(r.x0, r.y0, _canvas.getBuffer() + r.y0 * _canvas.width() + r.x0, _canvas.width(), r.x1 - r.x0 + 1, r.y1 - r.y0 + 1);
+
+    now = gfxMicros();
+    GFXupdateStats *s = &_stats[r.priority];
+    uint32_t latency = now - r.invalidated;
+    s->flushed++;
+    s->totalUs += latency;
+    if (latency > s->maxUs)
+        s->maxUs = latency;
+    if (r.hasDeadline && ((int32_t)(now - r.deadline) > 0))
+        s->missed++;
+    return _count != 0;
+}
+
+/*!
+    @brief   Copy pending regions to the display, most urgent first.
+    @param   budgetUs  If nonzero, stop once this much time has been spent
+                       (checked between regions, so the last region may
+                       overrun it).
+    @return  Number of regions flushed.
+*/
+uint8_t GFXupdateScheduler::flush(uint32_t budgetUs)
+{
+    uint32_t t0 = gfxMicros();
+    uint8_t n = 0;
+    while (_count)
+    {
+        flushNext();
+        n++;
+        if (budgetUs && ((gfxMicros() - t0) >= budgetUs))
+            break;
+    }
+    return n;
+}
+
+/*!
+    @brief   Find the pair of regions to merge when the list is full: of
+             the least urgent class with at least two regions, the pair
+             whose bounding box adds the least area.
+    @param   r  Region being added, counted as index _count.
+    @param   a  First index of the pair, filled in.
+    @param   b  Second index of the pair, filled in.
+    @return  false if no class has two regions.
+*/
+bool GFXupdateScheduler::cheapestPair(const Region *r, uint8_t *a, uint8_t *b) const
+{
+    for (int8_t cls = GFX_UPDATE_PRIORITIES - 1; cls >= 0; cls--)
+    {
+        int32_t best = 0x7FFFFFFF;
+        for (uint16_t i = 0; i < _count; i++)
+        {
+            const Region *p = &_regions[i];
+            if (p->priority != cls)
+                continue;
+            for (uint16_t j = i + 1; j <= _count; j++)
+            {
+                const Region *q = (j == _count) ? r : &_regions[j];
+                if (q->priority != cls)
+                    continue;
+                int32_t grow = (int32_t)(max(p->x1, q->x1) - min(p->x0, q->x0) + 1) * (max(p->y1, q->y1) - min(p->y0, q->y0) + 1) -
+                               (int32_t)(p->x1 - p->x0 + 1) * (p->y1 - p->y0 + 1) - (int32_t)(q->x1 - q->x0 + 1) * (q->y1 - q->y0 + 1);
+                if (grow < best)
+                {
+                    best = grow;
+                    *a = i;
+                    *b = j;
+                }
+            }
+        }
+        if (best != 0x7FFFFFFF)
+            return true;
+    }
+    return false;
+}
+
+/*!
+    @brief   Get the number of regions waiting to be flushed.
+    @return  Pending region count.
+*/
+uint8_t GFXupdateScheduler::pending(void) const
+{
+    return _count;
+}
+
+/*!
+    @brief   Get latency statistics for a priority class.
+    @param   priority  Priority class.
+    @return  Statistics since construction or resetStats().
+*/
+const GFXupdateStats &GFXupdateScheduler::stats(uint8_t priority) const
+{
+    return _stats[min(priority, GFX_UPDATE_PRIORITIES - 1)];
+}
+
+/*!
+    @brief  Clear the latency statistics of all priority classes.
+*/
+void GFXupdateScheduler::resetStats(void)
+{
+    memset(_stats, 0, sizeof(_stats));
+}
+
+/*!
+    @brief  Merge a pending region into another: bounds are united, the
+            more urgent priority, earlier invalidation time and earlier
+            deadline are kept.
+    @param  into  Region to grow.
+    @param  from  Region merged in.
+*/
+void GFXupdateScheduler::merge(Region *into, const Region *from)
+{
+    into->x0 = min(into->x0, from->x0);
+    into->y0 = min(into->y0, from->y0);
+    into->x1 = max(into->x1, from->x1);
+    into->y1 = max(into->y1, from->y1);
+    into->priority = min(into->priority, from->priority);
+    if ((int32_t)(from->invalidated - into->invalidated) < 0)
+        into->invalidated = from->invalidated;
+    if (from->hasDeadline && (!into->hasDeadline || ((int32_t)(from->deadline - into->deadline) < 0)))
+    {
+        into->hasDeadline = true;
+        into->deadline = from->deadline;
+    }
+}
+
+/*!
+    @brief   Flush ordering: lower priority class first; within a class,
+             regions with deadlines (earliest first), then oldest first.
+    @param   a    Candidate region.
+    @param   b    Current choice.
+    @param   now  Current time (gfxMicros()).
+    @return  true if a should be flushed before b.
+*/
+bool GFXupdateScheduler::before(const Region *a, const Region *b, uint32_t now) const
+{
+    if (a->priority != b->priority)
+        return a->priority < b->priority;
+    if (a->hasDeadline != b->hasDeadline)
+        return a->hasDeadline;
+    if (a->hasDeadline)
+        return (int32_t)(a->deadline - now) < (int32_t)(b->deadline - now);
+    return (int32_t)(now - a->invalidated) > (int32_t)(now - b->invalidated);
+}
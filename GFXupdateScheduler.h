@@ -0,0 +1,73 @@
+/*!
+ * @file GFXupdateScheduler.h
+ *
+ * Part of Adafruit's GFX graphics library. Priority-ordered screen updates:
+ * the application draws into a canvas holding the screen contents and
+ * invalidates the regions it changed, each with a priority class and an
+ * optional deadline. flush() then copies regions to the display most
+ * urgent first, one region at a time, so an alarm banner isn't held up
+ * behind a slow chart redraw and a time budget can stop the flush between
+ * regions.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXUPDATESCHEDULER_H_
+#define _GFXUPDATESCHEDULER_H_
+
+#include "Adafruit_GFX.h"
+
+#define GFX_UPDATE_PRIORITIES 4 ///< Priority classes, 0 = most urgent
+
+/// Latency statistics for one priority class
+typedef struct
+{
+	uint32_t flushed;  ///< Regions flushed
+	uint32_t missed;   ///< Regions flushed after their deadline
+	uint32_t totalUs;  ///< Sum of invalidate-to-flush latencies
+	uint32_t maxUs;	///< Worst invalidate-to-flush latency
+} GFXupdateStats;
+
+/*!
+  @brief  Copies invalidated regions of a GFXcanvas16 to a display in
+          priority order. The canvas mirrors the screen (or its top left
+          part) at the display's current rotation; draw into it with the
+          canvas at rotation 0.
+*/
+class GFXupdateScheduler
+{
+public:
+	GFXupdateScheduler(GFXcanvas16 &canvas, Adafruit_GFX &display, uint8_t maxRegions = 16);
+	~GFXupdateScheduler(void);
+
+	bool invalidate(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t priority = 0, uint32_t deadlineUs = 0);
+	bool flushNext(void);
+	uint8_t flush(uint32_t budgetUs = 0);
+	uint8_t pending(void) const;
+
+	const GFXupdateStats &stats(uint8_t priority) const;
+	void resetStats(void);
+
+private:
+	/// One pending region
+	struct Region
+	{
+		int16_t x0, y0, x1, y1; ///< Inclusive bounds
+		uint8_t priority;		///< Priority class
+		bool hasDeadline;		///< If set, deadline is valid
+		uint32_t invalidated;	///< Time first invalidated (gfxMicros())
+		uint32_t deadline;		///< Flush-by time (gfxMicros())
+	};
+
+	void merge(Region *into, const Region *from);
+	bool cheapestPair(const Region *r, uint8_t *a, uint8_t *b) const;
+	bool before(const Region *a, const Region *b, uint32_t now) const;
+
+	GFXcanvas16 &_canvas;
+	Adafruit_GFX &_display;
+	Region *_regions; ///< maxRegions entries, first _count in use
+	uint8_t _maxRegions, _count;
+	GFXupdateStats _stats[GFX_UPDATE_PRIORITIES];
+};
+
+#endif // _GFXUPDATESCHEDULER_H_
@@ -0,0 +1,414 @@
+/*!
+ * @file GFXvirtualDisplay.cpp
+ *
+ * Part of Adafruit's GFX graphics library. A virtual display spanning
+ * several Adafruit_SPITFT panels.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXvirtualDisplay.h"
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief  GFXvirtualDisplay constructor. Panels are then placed with
+            addPanel().
+    @param  w          Display width, in pixels (at rotation 0).
+    @param  h          Display height, in pixels (at rotation 0).
+    @param  maxPanels  Number of panels that can be added.
+*/
+GFXvirtualDisplay::GFXvirtualDisplay(int16_t w, int16_t h, uint8_t maxPanels)
+    : Adafruit_GFX(w, h), _maxPanels(maxPanels), _count(0)
+{
+    _panels = (Panel *)malloc(_maxPanels * sizeof(Panel));
+}
+
+/*!
+    @brief  Free the panel list and transfer buffers. The panels themselves
+            belong to the caller.
+*/
+GFXvirtualDisplay::~GFXvirtualDisplay(void)
+{
+    if (_panels)
+    {
+        for (uint8_t i = 0; i < _count; i++)
+        {
+            if (_panels[i].buf)
+                free(_panels[i].buf);
+        }
+        free(_panels);
+    }
+}
+
+/*!
+    @brief   Place a panel in the virtual display. The panel should already
+             be initialized and set to the rotation it's mounted at; its
+             width() and height() then give the area it covers.
+    @param   panel  The display.
+    @param   x      Left edge of the panel's area (virtual display
+                    coordinates, rotation 0).
+    @param   y      Top edge of the panel's area.
+    @return  true on success, false if the panel list is full or couldn't
+             be allocated.
+*/
+bool GFXvirtualDisplay::addPanel(Adafruit_SPITFT &panel, int16_t x, int16_t y)
+{
+    if (!_panels || (_count >= _maxPanels))
+        return false;
+
+    Panel *p = &_panels[_count++];
+    p->tft = &panel;
+    p->x = x;
+    p->y = y;
+    p->w = panel.width();
+    p->h = panel.height();
+    // Without a transfer buffer the panel is still drawn, just not
+    // concurrently with the others
+    p->buf = (uint16_t *)malloc(2 * GFX_PANEL_CHUNK * sizeof(uint16_t));
+    p->left = 0;
+    return true;
+}
+
+/*!
+    @brief   Get the number of panels placed.
+    @return  Panel count.
+*/
+uint8_t GFXvirtualDisplay::panels(void) const
+{
+    return _count;
+}
+
+/*!
+    @brief  Draw a pixel to whichever panel covers it.
+    @param  x      Horizontal position (0 = left).
+    @param  y      Vertical position   (0 = top).
+    @param  color  16-bit 5-6-5 pixel color.
+*/
+void GFXvirtualDisplay::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    int16_t w = 1, h = 1;
+    if (!rotateRect(&x, &y, &w, &h))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Panel *p = &_panels[i];
+        if (clipTo(p, x, y, w, h))
+            p->tft->drawPixel(p->cx, p->cy, color);
+    }
+}
+
+/*!
+    @brief  Start a write transaction on every panel.
+*/
+void GFXvirtualDisplay::startWrite(void)
+{
+    for (uint8_t i = 0; i < _count; i++)
+        _panels[i].tft->startWrite();
+}
+
+/*!
+    @brief  Draw a pixel to whichever panel covers it. Not self-contained;
+            should follow startWrite().
+    @param  x      Horizontal position (0 = left).
+    @param  y      Vertical position   (0 = top).
+    @param  color  16-bit 5-6-5 pixel color.
+*/
+void GFXvirtualDisplay::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    int16_t w = 1, h = 1;
+    if (!rotateRect(&x, &y, &w, &h))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Panel *p = &_panels[i];
+        if (clipTo(p, x, y, w, h))
+            p->tft->writePixel(p->cx, p->cy, color);
+    }
+}
+
+/*!
+    @brief  Draw a filled rectangle, split at panel boundaries. Not
+            self-contained; should follow startWrite().
+    @param  x      Top left corner horizontal coordinate.
+    @param  y      Top left corner vertical coordinate.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXvirtualDisplay::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (!rotateRect(&x, &y, &w, &h))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        Panel *p = &_panels[i];
+        if (clipTo(p, x, y, w, h))
+            p->tft->writeFillRect(p->cx, p->cy, p->cw, p->ch, color);
+    }
+}
+
+/*!
+    @brief  Draw a vertical line, split at panel boundaries. Not
+            self-contained; should follow startWrite().
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  h      Line height in pixels (positive = below first point,
+                   negative = above first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXvirtualDisplay::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    writeFillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Draw a horizontal line, split at panel boundaries. Not
+            self-contained; should follow startWrite().
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  w      Line width in pixels (positive = right of first point,
+                   negative = left of first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXvirtualDisplay::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    writeFillRect(x, y, w, 1, color);
+}
+
+/*!
+    @brief  End the write transaction on every panel.
+*/
+void GFXvirtualDisplay::endWrite(void)
+{
+    for (uint8_t i = 0; i < _count; i++)
+        _panels[i].tft->endWrite();
+}
+
+/*!
+    @brief  Invert the colors of every panel.
+    @param  i  true = inverted display, false = normal display.
+*/
+void GFXvirtualDisplay::invertDisplay(boolean i)
+{
+    for (uint8_t n = 0; n < _count; n++)
+        _panels[n].tft->invertDisplay(i);
+}
+
+/*!
+    @brief  Draw a vertical line. Self-contained.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  h      Line height in pixels (positive = below first point,
+                   negative = above first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXvirtualDisplay::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Draw a horizontal line. Self-contained.
+    @param  x      Horizontal position of first point.
+    @param  y      Vertical position of first point.
+    @param  w      Line width in pixels (positive = right of first point,
+                   negative = left of first point).
+    @param  color  16-bit line color in '565' RGB format.
+*/
+void GFXvirtualDisplay::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+/*!
+    @brief  Draw a filled rectangle. The part on each panel is sent to all
+            panels at once (see pushConcurrent()). Self-contained.
+    @param  x      Top left corner horizontal coordinate.
+    @param  y      Top left corner vertical coordinate.
+    @param  w      Width in pixels.
+    @param  h      Height in pixels.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXvirtualDisplay::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (!rotateRect(&x, &y, &w, &h))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+        clipTo(&_panels[i], x, y, w, h);
+    pushConcurrent(0, 0, NULL, 0, color);
+}
+
+/*!
+    @brief  Fill the whole virtual display, all panels at once.
+    @param  color  16-bit fill color in '565' RGB format.
+*/
+void GFXvirtualDisplay::fillScreen(uint16_t color)
+{
+    fillRect(0, 0, _width, _height, color);
+}
+
+/*!
+    @brief  Draw a RAM-resident 16-bit image (RGB 5/6/5). Self-contained.
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  Array of 16-bit 5-6-5 colors.
+    @param  w       Width of bitmap in pixels.
+    @param  h       Height of bitmap in pixels.
+*/
+void GFXvirtualDisplay::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h)
+{
+    drawRGBSubBitmap(x, y, bitmap, w, w, h);
+}
+
+/*!
+    @brief  Draw a rectangular region of a larger 16-bit image. At rotation
+            0 the part on each panel is sent to all panels at once (see
+            pushConcurrent()); otherwise the image is drawn pixel by pixel.
+            Self-contained.
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  bitmap  Pointer to the region's top left pixel.
+    @param  stride  Distance between rows of the image, in pixels.
+    @param  w       Width of region in pixels.
+    @param  h       Height of region in pixels.
+*/
+void GFXvirtualDisplay::drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h)
+{
+    if (rotation)
+    {
+        Adafruit_GFX::drawRGBSubBitmap(x, y, bitmap, stride, w, h);
+        return;
+    }
+    if ((w <= 0) || (h <= 0))
+        return;
+    for (uint8_t i = 0; i < _count; i++)
+        clipTo(&_panels[i], x, y, w, h);
+    pushConcurrent(x, y, bitmap, stride, 0);
+}
+
+/*!
+    @brief   Work out the part of an (unrotated) rectangle on a panel, as
+             the panel's current transfer.
+    @param   p  Panel.
+    @param   x  Left edge, virtual display coordinates.
+    @param   y  Top edge.
+    @param   w  Width in pixels.
+    @param   h  Height in pixels.
+    @return  true if any of the rectangle is on the panel (and within the
+             virtual display); otherwise the panel gets an empty transfer.
+*/
+bool GFXvirtualDisplay::clipTo(Panel *p, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    int16_t x0 = max(max(x, p->x), 0), y0 = max(max(y, p->y), 0),
+            x1 = min(min(x + w, p->x + p->w), WIDTH),
+            y1 = min(min(y + h, p->y + p->h), HEIGHT);
+    if ((x1 <= x0) || (y1 <= y0))
+    {
+        p->cw = p->ch = 0;
+        p->left = 0;
+        return false;
+    }
+    p->cx = x0 - p->x;
+    p->cy = y0 - p->y;
+    p->cw = x1 - x0;
+    p->ch = y1 - y0;
+    p->left = (uint32_t)p->cw * p->ch;
+    p->half = 0;
+    return true;
+}
+
+/*!
+    @brief  Send each panel's current transfer (set up by clipTo()), all
+            panels at once. Every panel gets an address window, then the
+            panels are visited in turn, each being handed its next chunk of
+            pixels from its own double buffer. Handing a panel a chunk only
+            waits for that panel's previous chunk, so with asynchronous SPI
+            all the buses run in parallel while the CPU refills buffers.
+            Panels without a buffer are drawn first, one after another.
+    @param  x       Left edge of the image, virtual display coordinates
+                    (bitmaps only).
+    @param  y       Top edge of the image (bitmaps only).
+    @param  bitmap  Image pixels, or NULL to fill with color.
+    @param  stride  Distance between rows of the image, in pixels.
+    @param  color   Fill color, if bitmap is NULL.
+*/
+void GFXvirtualDisplay::pushConcurrent(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, uint16_t color)
+{
+    uint16_t be = (color << 8) | (color >> 8); // Display (big-endian) order
+    uint8_t i;
+
+    for (i = 0; i < _count; i++)
+    {
+        Panel *p = &_panels[i];
+        if (!p->left)
+            continue;
+        if (!p->buf)
+        {
+            if (bitmap)
+                p->tft->drawRGBSubBitmap(p->cx, p->cy, bitmap + (p->y + p->cy - y) * stride + (p->x + p->cx - x), stride, p->cw, p->ch);
+            else
+                p->tft->fillRect(p->cx, p->cy, p->cw, p->ch, color);
+            p->left = 0;
+            continue;
+        }
+        if (!bitmap)
+        { // A fill re-sends the same chunk
+            for (uint16_t k = 0; k < GFX_PANEL_CHUNK; k++)
+                p->buf[k] = be;
+        }
+        p->tft->startWrite();
+        p->tft->setAddrWindow(p->cx, p->cy, p->cw, p->ch);
+    }
+
+    bool more;
+    do
+    {
+        more = false;
+        for (i = 0; i < _count; i++)
+        {
+            Panel *p = &_panels[i];
+            if (!p->left)
+                continue;
+
+            uint32_t len = min(p->left, (uint32_t)GFX_PANEL_CHUNK);
+            uint16_t *chunk = p->buf;
+            if (bitmap)
+            { // Copy the next pixels of the panel's region, row by row
+                chunk += p->half * GFX_PANEL_CHUNK;
+                p->half ^= 1;
+                uint32_t done = (uint32_t)p->cw * p->ch - p->left;
+                int16_t col = done % p->cw, row = done / p->cw;
+                uint16_t *src = bitmap + (p->y + p->cy + row - y) * stride + (p->x + p->cx + col - x);
+                for (uint32_t k = 0; k < len; k++)
+                {
+                    uint16_t c = *src++;
+                    chunk[k] = (c << 8) | (c >> 8);
+                    if (++col == p->cw)
+                    {
+                        col = 0;
+                        src += stride - p->cw;
+                    }
+                }
+            }
+            p->tft->writePixels(chunk, len, false, true);
+            if ((p->left -= len))
+                more = true;
+        }
+    } while (more);
+
+    for (i = 0; i < _count; i++)
+    {
+        Panel *p = &_panels[i];
+        if (p->buf && (p->cw > 0))
+        {
+            p->tft->dmaWait();
+            p->tft->endWrite();
+        }
+    }
+}
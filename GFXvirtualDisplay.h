@@ -0,0 +1,71 @@
+/*!
+ * @file GFXvirtualDisplay.h
+ *
+ * Part of Adafruit's GFX graphics library. A virtual display made of
+ * several Adafruit_SPITFT panels (a video wall), each normally on its own
+ * SPI peripheral. Primitives and bitmaps are split at panel boundaries,
+ * and large fills and bitmap pushes feed all panels in turn from small
+ * per-panel buffers, so with asynchronous SPI the buses transfer at the
+ * same time and a full-wall update takes about as long as one panel.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXVIRTUALDISPLAY_H_
+#define _GFXVIRTUALDISPLAY_H_
+
+#include "Adafruit_SPITFT.h"
+
+#define GFX_PANEL_CHUNK 128 ///< Pixels per per-panel transfer
+
+/*!
+  @brief  An Adafruit_GFX spanning several displays. Panels are placed in
+          the virtual display's unrotated coordinate space, each covering
+          its own width() x height() at its own current rotation. Areas
+          not covered by any panel are clipped away.
+*/
+class GFXvirtualDisplay : public Adafruit_GFX
+{
+public:
+	GFXvirtualDisplay(int16_t w, int16_t h, uint8_t maxPanels = 4);
+	~GFXvirtualDisplay(void);
+
+	bool addPanel(Adafruit_SPITFT &panel, int16_t x, int16_t y);
+	uint8_t panels(void) const;
+
+	void drawPixel(int16_t x, int16_t y, uint16_t color);
+	void startWrite(void);
+	void writePixel(int16_t x, int16_t y, uint16_t color);
+	void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void endWrite(void);
+	void invertDisplay(boolean i);
+	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+	void fillScreen(uint16_t color);
+	using Adafruit_GFX::drawRGBBitmap; // Check base class first
+	void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h);
+	void drawRGBSubBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, int16_t w, int16_t h);
+
+private:
+	/// One physical display and its part of the wall
+	struct Panel
+	{
+		Adafruit_SPITFT *tft;	///< The display
+		int16_t x, y, w, h;		///< Area covered, unrotated virtual coordinates
+		uint16_t *buf;			///< 2 * GFX_PANEL_CHUNK big-endian pixels (or NULL)
+		int16_t cx, cy, cw, ch; ///< Current transfer, panel coordinates
+		uint32_t left;			///< Pixels of current transfer not yet issued
+		uint8_t half;			///< Buffer half to fill next
+	};
+
+	bool clipTo(Panel *p, int16_t x, int16_t y, int16_t w, int16_t h);
+	void pushConcurrent(int16_t x, int16_t y, uint16_t *bitmap, int16_t stride, uint16_t color);
+
+	Panel *_panels; ///< maxPanels entries, first _count in use
+	uint8_t _maxPanels, _count;
+};
+
+#endif // _GFXVIRTUALDISPLAY_H_
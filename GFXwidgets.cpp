@@ -0,0 +1,383 @@
+/*!
+ * @file GFXwidgets.cpp
+ *
+ * Part of Adafruit's GFX graphics library. Bars, segmented meters and
+ * needle gauges with incremental updates.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#include "GFXwidgets.h"
+#include <math.h>
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/*!
+    @brief  Fill the part of a bar between two distances from its empty
+            end. Not self-contained; should follow startWrite().
+    @param  gfx    Display.
+    @param  dir    GFX_FILL_RIGHT, GFX_FILL_UP, etc.
+    @param  x      Left edge of the bar.
+    @param  y      Top edge of the bar.
+    @param  w      Width of the bar.
+    @param  h      Height of the bar.
+    @param  from   Start distance.
+    @param  to     End distance (exclusive; nothing drawn if not past from).
+    @param  color  16-bit 5-6-5 color.
+*/
+static void fillAlong(Adafruit_GFX &gfx, uint8_t dir, int16_t x, int16_t y, int16_t w, int16_t h, int16_t from, int16_t to, uint16_t color)
+{
+    if (to <= from)
+        return;
+    switch (dir)
+    {
+    case GFX_FILL_UP:
+        gfx.writeFillRect(x, y + h - to, w, to - from, color);
+        break;
+    case GFX_FILL_LEFT:
+        gfx.writeFillRect(x + w - to, y, to - from, h, color);
+        break;
+    case GFX_FILL_DOWN:
+        gfx.writeFillRect(x, y + from, w, to - from, color);
+        break;
+    default:
+        gfx.writeFillRect(x + from, y, to - from, h, color);
+        break;
+    }
+}
+
+// BAR ---------------------------------------------------------------------
+
+/*!
+    @brief  GFXbar constructor. Nothing is drawn until draw() or
+            setValue(); the value starts at minValue.
+    @param  gfx        Display (or canvas) to draw on.
+    @param  x          Left edge.
+    @param  y          Top edge.
+    @param  w          Width.
+    @param  h          Height.
+    @param  minValue   Value of an empty bar.
+    @param  maxValue   Value of a full bar (values outside the range are
+                       clamped).
+    @param  color      Bar color.
+    @param  bg         Background color.
+    @param  direction  GFX_FILL_RIGHT, GFX_FILL_UP, GFX_FILL_LEFT or
+                       GFX_FILL_DOWN.
+*/
+GFXbar::GFXbar(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, int16_t minValue, int16_t maxValue, uint16_t color, uint16_t bg, uint8_t direction)
+    : _gfx(gfx), _x(x), _y(y), _w(max(w, 1)), _h(max(h, 1)), _color(color), _bg(bg), _dir(direction & 3), _len(-1)
+{
+    _min = minValue;
+    _max = (maxValue > minValue) ? maxValue : minValue + 1;
+    _value = minValue;
+}
+
+/*!
+    @brief  Draw the whole bar.
+*/
+void GFXbar::draw(void)
+{
+    int16_t span = (_dir & 1) ? _h : _w;
+    _len = length(_value);
+    _gfx.startWrite();
+    fillAlong(_gfx, _dir, _x, _y, _w, _h, 0, _len, _color);
+    fillAlong(_gfx, _dir, _x, _y, _w, _h, _len, span, _bg);
+    _gfx.endWrite();
+}
+
+/*!
+    @brief  Change the value, drawing only the part of the bar that grew
+            or shrank (the whole bar if not drawn yet).
+    @param  value  New value.
+*/
+void GFXbar::setValue(int16_t value)
+{
+    _value = value;
+    if (_len < 0)
+    {
+        draw();
+        return;
+    }
+    int16_t len = length(value);
+    if (len == _len)
+        return;
+    _gfx.startWrite();
+    if (len > _len)
+        fillAlong(_gfx, _dir, _x, _y, _w, _h, _len, len, _color);
+    else
+        fillAlong(_gfx, _dir, _x, _y, _w, _h, len, _len, _bg);
+    _gfx.endWrite();
+    _len = len;
+}
+
+/*!
+    @brief   Get the value.
+    @return  Last value set.
+*/
+int16_t GFXbar::value(void) const
+{
+    return _value;
+}
+
+/*!
+    @brief  Change the colors, redrawing the bar if drawn.
+    @param  color  Bar color.
+    @param  bg     Background color.
+*/
+void GFXbar::setColors(uint16_t color, uint16_t bg)
+{
+    _color = color;
+    _bg = bg;
+    if (_len >= 0)
+        draw();
+}
+
+/*!
+    @brief   Map a value to a filled length.
+    @param   value  Value.
+    @return  Length in pixels, 0 to the bar's width (or height).
+*/
+int16_t GFXbar::length(int16_t value) const
+{
+    value = min(max(value, _min), _max);
+    return (int32_t)(value - _min) * ((_dir & 1) ? _h : _w) / ((int32_t)_max - _min);
+}
+
+// SEGMENTED METER ---------------------------------------------------------
+
+/*!
+    @brief  GFXmeter constructor. Nothing is drawn until draw() or
+            setValue(); the value starts at minValue.
+    @param  gfx        Display (or canvas) to draw on.
+    @param  x          Left edge.
+    @param  y          Top edge.
+    @param  w          Width.
+    @param  h          Height.
+    @param  segments   Number of segments (at least 1).
+    @param  gap        Pixels between segments.
+    @param  minValue   Value with no segment lit.
+    @param  maxValue   Value with all segments lit (values outside the
+                       range are clamped).
+    @param  color      Color of lit segments (see setSegmentColors()).
+    @param  offColor   Color of unlit segments.
+    @param  bg         Color of the gaps.
+    @param  direction  GFX_FILL_RIGHT, GFX_FILL_UP, GFX_FILL_LEFT or
+                       GFX_FILL_DOWN.
+*/
+GFXmeter::GFXmeter(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t segments, uint8_t gap, int16_t minValue, int16_t maxValue, uint16_t color, uint16_t offColor, uint16_t bg, uint8_t direction)
+    : _gfx(gfx), _x(x), _y(y), _w(max(w, 1)), _h(max(h, 1)), _segments(max(segments, 1)), _gap(gap), _color(color), _offColor(offColor), _bg(bg), _colors(NULL), _dir(direction & 3), _lit(-1)
+{
+    _min = minValue;
+    _max = (maxValue > minValue) ? maxValue : minValue + 1;
+    _value = minValue;
+}
+
+/*!
+    @brief  Draw the whole meter: segments and gaps.
+*/
+void GFXmeter::draw(void)
+{
+    int32_t span = ((_dir & 1) ? _h : _w) + _gap;
+    _lit = lit(_value);
+    _gfx.startWrite();
+    for (uint8_t i = 0; i < _segments; i++)
+    {
+        segment(i, (i < _lit) ? (_colors ? _colors[i] : _color) : _offColor);
+        if (i + 1 < _segments) // Gap after
+            fillAlong(_gfx, _dir, _x, _y, _w, _h, (i + 1) * span / _segments - _gap, (i + 1) * span / _segments, _bg);
+    }
+    _gfx.endWrite();
+}
+
+/*!
+    @brief  Change the value, drawing only the segments that turn on or
+            off (the whole meter if not drawn yet).
+    @param  value  New value.
+*/
+void GFXmeter::setValue(int16_t value)
+{
+    _value = value;
+    if (_lit < 0)
+    {
+        draw();
+        return;
+    }
+    uint8_t n = lit(value);
+    if (n == _lit)
+        return;
+    _gfx.startWrite();
+    for (uint8_t i = min(n, _lit); i < max(n, _lit); i++)
+        segment(i, (i < n) ? (_colors ? _colors[i] : _color) : _offColor);
+    _gfx.endWrite();
+    _lit = n;
+}
+
+/*!
+    @brief   Get the value.
+    @return  Last value set.
+*/
+int16_t GFXmeter::value(void) const
+{
+    return _value;
+}
+
+/*!
+    @brief  Give each segment its own lit color, redrawing the meter if
+            drawn.
+    @param  colors  One color per segment, from the empty end (kept, not
+                    copied), or NULL to use the constructor's color.
+*/
+void GFXmeter::setSegmentColors(const uint16_t *colors)
+{
+    _colors = colors;
+    if (_lit >= 0)
+        draw();
+}
+
+/*!
+    @brief   Map a value to a number of lit segments.
+    @param   value  Value.
+    @return  Segments lit, 0 to all.
+*/
+uint8_t GFXmeter::lit(int16_t value) const
+{
+    value = min(max(value, _min), _max);
+    return (int32_t)(value - _min) * _segments / ((int32_t)_max - _min);
+}
+
+/*!
+    @brief  Fill one segment. Not self-contained; should follow
+            startWrite().
+    @param  i      Segment, 0 at the empty end.
+    @param  color  16-bit 5-6-5 color.
+*/
+void GFXmeter::segment(uint8_t i, uint16_t color)
+{
+    int32_t span = ((_dir & 1) ? _h : _w) + _gap;
+    fillAlong(_gfx, _dir, _x, _y, _w, _h, i * span / _segments, (i + 1) * span / _segments - _gap, color);
+}
+
+// NEEDLE GAUGE ------------------------------------------------------------
+
+/*!
+    @brief  GFXgauge constructor. Nothing is drawn until draw() or
+            setValue(); the value starts at minValue. The dial spans
+            -135 to +135 degrees (see setAngles()).
+    @param  gfx        Display (or canvas) to draw on.
+    @param  cx         Center x.
+    @param  cy         Center y.
+    @param  r          Radius of the dial.
+    @param  minValue   Value at the start of the dial.
+    @param  maxValue   Value at the end of the dial (values outside the
+                       range are clamped).
+    @param  needle     Needle color.
+    @param  bg         Dial color.
+    @param  tickColor  Color of the tick marks and needle hub.
+    @param  ticks      Tick marks, evenly spaced from start to end.
+*/
+GFXgauge::GFXgauge(Adafruit_GFX &gfx, int16_t cx, int16_t cy, int16_t r, int16_t minValue, int16_t maxValue, uint16_t needle, uint16_t bg, uint16_t tickColor, uint8_t ticks)
+    : _gfx(gfx), _cx(cx), _cy(cy), _r(max(r, 8)), _needleColor(needle), _bg(bg), _tickColor(tickColor), _ticks(ticks), _start(-135), _sweep(270), _drawn(false)
+{
+    _min = minValue;
+    _max = (maxValue > minValue) ? maxValue : minValue + 1;
+    _value = minValue;
+}
+
+/*!
+    @brief  Draw the whole gauge: dial, ticks, needle and hub.
+*/
+void GFXgauge::draw(void)
+{
+    int16_t tick = max(3, _r / 8);
+    _gfx.fillCircle(_cx, _cy, _r, _bg);
+    for (uint8_t i = 0; i < _ticks; i++)
+    {
+        float a = (_start + ((_ticks > 1) ? (int32_t)_sweep * i / (_ticks - 1) : 0)) * 3.14159265f / 180;
+        float s = sinf(a), c = cosf(a);
+        _gfx.drawLine(_cx + floorf((_r - tick) * s + 0.5f), _cy - floorf((_r - tick) * c + 0.5f),
+                      _cx + floorf(_r * s + 0.5f), _cy - floorf(_r * c + 0.5f), _tickColor);
+    }
+    needle(_value, &_needle);
+    _gfx.fillTriangle(_needle.x0, _needle.y0, _needle.x1, _needle.y1, _needle.x2, _needle.y2, _needleColor);
+    hub();
+    _drawn = true;
+}
+
+/*!
+    @brief  Change the value, erasing the old needle and drawing the new one
+            (the whole gauge if not drawn yet). Nothing is drawn if the
+            needle doesn't move by a pixel.
+    @param  value  New value.
+*/
+void GFXgauge::setValue(int16_t value)
+{
+    _value = value;
+    if (!_drawn)
+    {
+        draw();
+        return;
+    }
+    Needle n;
+    needle(value, &n);
+    if (!memcmp(&n, &_needle, sizeof(n)))
+        return;
+    _gfx.fillTriangle(_needle.x0, _needle.y0, _needle.x1, _needle.y1, _needle.x2, _needle.y2, _bg);
+    _gfx.fillTriangle(n.x0, n.y0, n.x1, n.y1, n.x2, n.y2, _needleColor);
+    hub();
+    _needle = n;
+}
+
+/*!
+    @brief   Get the value.
+    @return  Last value set.
+*/
+int16_t GFXgauge::value(void) const
+{
+    return _value;
+}
+
+/*!
+    @brief  Change the span of the dial, redrawing the gauge if drawn.
+    @param  start  Angle of minValue, degrees clockwise from 12 o'clock.
+    @param  sweep  Angle from minValue to maxValue (negative:
+                   anticlockwise).
+*/
+void GFXgauge::setAngles(int16_t start, int16_t sweep)
+{
+    _start = start;
+    _sweep = sweep;
+    if (_drawn)
+        draw();
+}
+
+/*!
+    @brief  Work out the needle's corners for a value.
+    @param  value  Value.
+    @param  n      Needle, filled in.
+*/
+void GFXgauge::needle(int16_t value, Needle *n) const
+{
+    int16_t len = _r - max(3, _r / 8) - 2, half = max(2, _r / 16);
+    value = min(max(value, _min), _max);
+    float a = (_start + (float)_sweep * (value - _min) / ((int32_t)_max - _min)) * 3.14159265f / 180;
+    float s = sinf(a), c = cosf(a);
+    n->x0 = _cx + floorf(len * s + 0.5f);
+    n->y0 = _cy - floorf(len * c + 0.5f);
+    n->x1 = _cx + floorf(half * c + 0.5f);
+    n->y1 = _cy + floorf(half * s + 0.5f);
+    n->x2 = _cx - floorf(half * c + 0.5f);
+    n->y2 = _cy - floorf(half * s + 0.5f);
+}
+
+/*!
+    @brief  Draw the hub over the needle's base.
+*/
+void GFXgauge::hub(void)
+{
+    _gfx.fillCircle(_cx, _cy, max(2, _r / 16) + 1, _tickColor);
+}
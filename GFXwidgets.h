@@ -0,0 +1,115 @@
+/*!
+ * @file GFXwidgets.h
+ *
+ * Part of Adafruit's GFX graphics library. Incremental widgets: bars,
+ * segmented meters and needle gauges that remember what they last drew
+ * and on a new value draw only the difference (the part of a bar that
+ * grew or shrank, the segments that changed, the old and new needle), so
+ * an update costs in proportion to the change, not the widget size.
+ *
+ * BSD license, all text here must be included in any redistribution.
+ */
+
+#ifndef _GFXWIDGETS_H_
+#define _GFXWIDGETS_H_
+
+#include "Adafruit_GFX.h"
+
+// Direction a bar or meter fills in as its value grows:
+#define GFX_FILL_RIGHT 0 ///< From the left edge
+#define GFX_FILL_UP 1	///< From the bottom edge
+#define GFX_FILL_LEFT 2  ///< From the right edge
+#define GFX_FILL_DOWN 3  ///< From the top edge
+
+/*!
+  @brief  Solid bar (progress bar, level) in a w x h rectangle, filled in
+          proportion to its value.
+*/
+class GFXbar
+{
+public:
+	GFXbar(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, int16_t minValue, int16_t maxValue, uint16_t color, uint16_t bg, uint8_t direction = GFX_FILL_RIGHT);
+
+	void draw(void);
+	void setValue(int16_t value);
+	int16_t value(void) const;
+	void setColors(uint16_t color, uint16_t bg);
+
+private:
+	int16_t length(int16_t value) const;
+
+	Adafruit_GFX &_gfx;
+	int16_t _x, _y, _w, _h;
+	int16_t _min, _max;
+	uint16_t _color, _bg;
+	uint8_t _dir;
+	int16_t _value;
+	int16_t _len; ///< Filled length drawn, -1 until draw()
+};
+
+/*!
+  @brief  Meter of separate segments (LED bar) in a w x h rectangle, lit in
+          proportion to its value. Segments may each have their own color
+          (e.g. green, then yellow, then red).
+*/
+class GFXmeter
+{
+public:
+	GFXmeter(Adafruit_GFX &gfx, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t segments, uint8_t gap, int16_t minValue, int16_t maxValue, uint16_t color, uint16_t offColor, uint16_t bg, uint8_t direction = GFX_FILL_RIGHT);
+
+	void draw(void);
+	void setValue(int16_t value);
+	int16_t value(void) const;
+	void setSegmentColors(const uint16_t *colors);
+
+private:
+	uint8_t lit(int16_t value) const;
+	void segment(uint8_t i, uint16_t color);
+
+	Adafruit_GFX &_gfx;
+	int16_t _x, _y, _w, _h;
+	uint8_t _segments, _gap;
+	int16_t _min, _max;
+	uint16_t _color, _offColor, _bg;
+	const uint16_t *_colors; ///< Per-segment lit colors, or NULL
+	uint8_t _dir;
+	int16_t _value;
+	int16_t _lit; ///< Segments lit as drawn, -1 until draw()
+};
+
+/*!
+  @brief  Round dial with tick marks and a tapered needle. Angles are in
+          degrees clockwise from 12 o'clock.
+*/
+class GFXgauge
+{
+public:
+	GFXgauge(Adafruit_GFX &gfx, int16_t cx, int16_t cy, int16_t r, int16_t minValue, int16_t maxValue, uint16_t needle, uint16_t bg, uint16_t tickColor, uint8_t ticks = 11);
+
+	void draw(void);
+	void setValue(int16_t value);
+	int16_t value(void) const;
+	void setAngles(int16_t start, int16_t sweep);
+
+private:
+	/// Needle corners: tip, then the two ends of the base
+	struct Needle
+	{
+		int16_t x0, y0, x1, y1, x2, y2;
+	};
+
+	void needle(int16_t value, Needle *n) const;
+	void hub(void);
+
+	Adafruit_GFX &_gfx;
+	int16_t _cx, _cy, _r;
+	int16_t _min, _max;
+	uint16_t _needleColor, _bg, _tickColor;
+	uint8_t _ticks;
+	int16_t _start, _sweep;
+	int16_t _value;
+	bool _drawn;
+	Needle _needle; ///< As drawn
+};
+
+#endif // _GFXWIDGETS_H_
@@ -17,6 +17,16 @@ typedef struct {
         int8_t   yOffset;          ///< Y dist from cursor pos to UL corner
 } GFXglyph;
 
+/// Font data stored PER GLYPH in streamed fonts (see GFXstreamFont.h)
+typedef struct {
+        uint32_t bitmapOffset;     ///< Offset into font bitmaps, not limited to 64K
+        uint8_t  width;            ///< Bitmap dimensions in pixels
+        uint8_t  height;           ///< Bitmap dimensions in pixels
+        uint8_t  xAdvance;         ///< Distance to advance cursor (x axis)
+        int8_t   xOffset;          ///< X dist from cursor pos to UL corner
+        int8_t   yOffset;          ///< Y dist from cursor pos to UL corner
+} GFXglyphExt;
+
 /// Data stored for FONT AS A WHOLE
 typedef struct { 
 	uint8_t  *bitmap;      ///< Glyph bitmaps, concatenated